@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/*
+ * Runs the JavaScript bridge benchmark page (index.html next to this file)
+ * inside the web app manager and prints the results it reports as JSON.
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <stdio.h>
+
+#include "benchharness.h"
+#include "jsonwriter.h"
+
+using luna::JsonWriter;
+
+namespace
+{
+
+const char *benchAppId = "org.webosports.bench.bridge";
+
+QByteArray waitForReport(QProcess &standin, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (timer.elapsed() < timeout) {
+        while (standin.canReadLine()) {
+            QByteArray line = standin.readLine().trimmed();
+            if (line.startsWith("report "))
+                return line.mid(7);
+        }
+
+        standin.waitForReadyRead(qMax<qint64>(1, timeout - timer.elapsed()));
+    }
+
+    return QByteArray();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures latency and throughput of the JavaScript bridge");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption(QStringList() << "n" << "iterations",
+                                        "Calls per measured path", "count", "200"));
+    parser.addOption(QCommandLineOption("page", "Benchmark page to load", "path", BRIDGE_BENCH_PAGE));
+    parser.addOption(QCommandLineOption("timeout", "Seconds to wait for the results", "seconds", "300"));
+    parser.addOption(QCommandLineOption(QStringList() << "o" << "output",
+                                        "Write the results to a file instead of stdout", "file"));
+    bench::Harness::addOptions(parser);
+    parser.process(app);
+
+    if (parser.isSet("no-standin")) {
+        fprintf(stderr, "The bridge benchmark needs the echo service of the stand-in\n");
+        return 1;
+    }
+
+    bench::Harness harness;
+    if (!harness.start(parser))
+        return 1;
+
+    JsonWriter params;
+    params.beginObject().member("iterations", qMax(1, parser.value("iterations").toInt())).endObject();
+
+    if (!harness.launchApp(benchAppId, parser.value("page"), 1000, params.data())) {
+        fprintf(stderr, "Failed to launch the benchmark page\n");
+        return 1;
+    }
+
+    QByteArray report = waitForReport(harness.standin(), parser.value("timeout").toInt() * 1000);
+    harness.killApp(benchAppId);
+
+    if (report.isEmpty()) {
+        fprintf(stderr, "The benchmark page did not report any results\n");
+        return 1;
+    }
+
+    if (parser.isSet("output")) {
+        QFile output(parser.value("output"));
+        if (!output.open(QIODevice::WriteOnly)) {
+            fprintf(stderr, "Failed to open %s\n", qPrintable(parser.value("output")));
+            return 1;
+        }
+        output.write(report);
+        output.write("\n");
+    }
+    else {
+        printf("%s\n", report.constData());
+    }
+
+    return 0;
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "benchharness.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QThread>
+#include <QUrl>
+
+#include <glib.h>
+#include <stdio.h>
+
+#include "jsonwriter.h"
+
+using luna::JsonWriter;
+
+namespace bench
+{
+
+Harness::Harness()
+{
+}
+
+Harness::~Harness()
+{
+    stop();
+}
+
+void Harness::addOptions(QCommandLineParser &parser)
+{
+    parser.addOption(QCommandLineOption("manager", "Path of the LunaWebAppManager binary",
+                                        "path", WEBAPPMANAGER_BINARY));
+    parser.addOption(QCommandLineOption("standin", "Path of the bus stand-in binary", "path",
+                                        QCoreApplication::applicationDirPath() + "/webappmanager-bus-standin"));
+    parser.addOption(QCommandLineOption("no-standin", "Use the services available on the bus"));
+}
+
+bool Harness::start(const QCommandLineParser &parser)
+{
+    mStandin.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    if (!parser.isSet("no-standin")) {
+        mStandin.start(parser.value("standin"));
+        if (!mStandin.waitForReadyRead(STARTUP_TIMEOUT_MSEC) || !mStandin.readLine().startsWith("ready")) {
+            fprintf(stderr, "Bus stand-in failed to start\n");
+            return false;
+        }
+    }
+
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("QT_QPA_PLATFORM", "offscreen");
+
+    mManager.setProcessEnvironment(environment);
+    mManager.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    mManager.setStandardOutputFile(QProcess::nullDevice());
+    mManager.start(parser.value("manager"));
+    if (!mManager.waitForStarted()) {
+        fprintf(stderr, "Failed to start %s\n", qPrintable(parser.value("manager")));
+        return false;
+    }
+
+    try {
+        mHandle.reset(new LS::Handle(LS::registerService()));
+        mHandle->attachToLoop(g_main_loop_new(g_main_context_default(), FALSE));
+    }
+    catch (LS::Error &error) {
+        fprintf(stderr, "Failed to register on the bus: %s\n", error.what());
+        return false;
+    }
+
+    if (!waitForService()) {
+        fprintf(stderr, "Web app manager service did not come up\n");
+        return false;
+    }
+
+    return true;
+}
+
+void Harness::stop()
+{
+    mHandle.reset();
+
+    QProcess *processes[] = { &mManager, &mStandin };
+    for (QProcess *process : processes) {
+        if (process->state() == QProcess::NotRunning)
+            continue;
+
+        process->terminate();
+        if (!process->waitForFinished(5000))
+            process->kill();
+    }
+}
+
+bool Harness::waitForService()
+{
+    QElapsedTimer startup;
+    startup.start();
+
+    while (startup.elapsed() < STARTUP_TIMEOUT_MSEC) {
+        try {
+            LS::Call call = mHandle->callOneReply("luna://org.webosports.webappmanager/listRunningApps", "{}");
+            LS::Message reply = call.get(1000);
+            if (reply && !reply.isHubError())
+                return true;
+        }
+        catch (LS::Error &error) {
+        }
+
+        QThread::msleep(100);
+    }
+
+    return false;
+}
+
+bool Harness::launchApp(const QString &appId, const QString &main, int processId, const QByteArray &params)
+{
+    JsonWriter request;
+    request.beginObject();
+    request.key("appDesc").beginObject();
+    request.member("id", appId);
+    request.member("title", appId);
+    // URLs with a scheme, i.e. remote cards, go through unchanged
+    QUrl url(main);
+    if (url.scheme().isEmpty()) {
+        request.member("main", QString("file://%1").arg(main));
+        request.member("folderPath", QFileInfo(main).absolutePath());
+    }
+    else {
+        request.member("main", main);
+    }
+    request.endObject();
+    if (!params.isEmpty())
+        request.key("params").rawValue(params);
+    request.member("processId", processId);
+    request.endObject();
+
+    try {
+        LS::Call call = mHandle->callOneReply("luna://org.webosports.webappmanager/launchApp",
+                                              request.constData());
+        LS::Message reply = call.get(STARTUP_TIMEOUT_MSEC);
+        return reply && parseReply(reply).value("returnValue").toBool();
+    }
+    catch (LS::Error &error) {
+    }
+
+    return false;
+}
+
+bool Harness::killApp(const QString &appId)
+{
+    JsonWriter request;
+    request.beginObject().member("appId", appId).endObject();
+
+    try {
+        LS::Call call = mHandle->callOneReply("luna://org.webosports.webappmanager/killApp",
+                                              request.constData());
+        LS::Message reply = call.get(STARTUP_TIMEOUT_MSEC);
+        return reply && parseReply(reply).value("returnValue").toBool();
+    }
+    catch (LS::Error &error) {
+    }
+
+    return false;
+}
+
+QJsonObject parseReply(LS::Message &reply)
+{
+    return QJsonDocument::fromJson(QByteArray(reply.getPayload())).object();
+}
+
+bool waitForAppEvent(LS::Call &events, const QString &event, const QString &appId, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (timer.elapsed() < timeout) {
+        LS::Message reply = events.get(timeout - timer.elapsed());
+        if (!reply)
+            return false;
+
+        QJsonObject payload = parseReply(reply);
+        if (payload.value("event").toString() == event && payload.value("appId").toString() == appId)
+            return true;
+    }
+
+    return false;
+}
+
+static qint64 processRss(qint64 pid)
+{
+    QFile status(QString("/proc/%1/status").arg(pid));
+    if (!status.open(QIODevice::ReadOnly))
+        return 0;
+
+    Q_FOREACH(const QByteArray &line, status.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+
+    return 0;
+}
+
+MemoryUsage processMemoryUsage(qint64 pid)
+{
+    MemoryUsage usage;
+
+    // smaps_rollup needs Linux 4.14, summing up smaps gives the same numbers
+    QFile smaps(QString("/proc/%1/smaps_rollup").arg(pid));
+    if (!smaps.open(QIODevice::ReadOnly)) {
+        smaps.setFileName(QString("/proc/%1/smaps").arg(pid));
+        if (!smaps.open(QIODevice::ReadOnly))
+            return usage;
+    }
+
+    Q_FOREACH(const QByteArray &line, smaps.readAll().split('\n')) {
+        int separator = line.indexOf(':');
+        if (separator < 0)
+            continue;
+
+        QByteArray field = line.left(separator);
+        qint64 value = line.mid(separator + 1).trimmed().split(' ').first().toLongLong();
+
+        if (field == "Pss")
+            usage.pss += value;
+        else if (field == "Private_Clean" || field == "Private_Dirty")
+            usage.uss += value;
+    }
+
+    return usage;
+}
+
+QList<qint64> descendantProcesses(qint64 pid)
+{
+    QList<qint64> descendants;
+
+    Q_FOREACH(const QString &entry, QDir("/proc").entryList(QDir::Dirs)) {
+        bool isPid = false;
+        qint64 childPid = entry.toLongLong(&isPid);
+        if (!isPid || childPid == pid)
+            continue;
+
+        QFile stat(QString("/proc/%1/stat").arg(childPid));
+        if (!stat.open(QIODevice::ReadOnly))
+            continue;
+
+        // the parent pid is the second field after the parenthesized command name
+        QByteArray data = stat.readAll();
+        QList<QByteArray> fields = data.mid(data.lastIndexOf(')') + 2).split(' ');
+        if (fields.size() > 1 && fields.at(1).toLongLong() == pid)
+            descendants << childPid << descendantProcesses(childPid);
+    }
+
+    return descendants;
+}
+
+QByteArray processCommandLine(qint64 pid)
+{
+    QFile cmdline(QString("/proc/%1/cmdline").arg(pid));
+    if (!cmdline.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    return cmdline.readAll().replace('\0', ' ').trimmed();
+}
+
+qint64 processTreeRss(qint64 pid)
+{
+    qint64 rss = processRss(pid);
+
+    Q_FOREACH(qint64 descendant, descendantProcesses(pid))
+        rss += processRss(descendant);
+
+    return rss;
+}
+
+double percentile(const QVector<double> &sorted, double p)
+{
+    if (sorted.isEmpty())
+        return 0;
+
+    int rank = qBound(0, (int) (p * sorted.size() + 0.999999) - 1, sorted.size() - 1);
+    return sorted.at(rank);
+}
+
+} // namespace bench
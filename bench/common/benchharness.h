@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QProcess>
+#include <QScopedPointer>
+#include <QString>
+#include <QVector>
+
+#include <luna-service2/lunaservice.hpp>
+
+class QCommandLineParser;
+
+namespace bench
+{
+
+const int STARTUP_TIMEOUT_MSEC = 30000;
+
+/*
+ * Runs LunaWebAppManager with the offscreen platform plugin next to the bus
+ * stand-in and provides a client handle to drive it. Both need a
+ * luna-service2 hub to register on.
+ */
+class Harness
+{
+public:
+    Harness();
+    ~Harness();
+
+    static void addOptions(QCommandLineParser &parser);
+
+    bool start(const QCommandLineParser &parser);
+    void stop();
+
+    LS::Handle &handle() { return *mHandle; }
+    QProcess &standin() { return mStandin; }
+    qint64 managerPid() const { return mManager.processId(); }
+
+    bool launchApp(const QString &appId, const QString &main, int processId,
+                   const QByteArray &params = QByteArray());
+    bool killApp(const QString &appId);
+
+private:
+    QProcess mStandin;
+    QProcess mManager;
+    QScopedPointer<LS::Handle> mHandle;
+
+    bool waitForService();
+
+    Q_DISABLE_COPY(Harness)
+};
+
+QJsonObject parseReply(LS::Message &reply);
+
+// Waits for an app event of the given kind for the app, skipping everything else.
+bool waitForAppEvent(LS::Call &events, const QString &event, const QString &appId, int timeout);
+
+struct MemoryUsage
+{
+    MemoryUsage() : pss(0), uss(0) {}
+
+    // both in kB
+    qint64 pss;
+    qint64 uss;
+
+    MemoryUsage &operator+=(const MemoryUsage &other) { pss += other.pss; uss += other.uss; return *this; }
+};
+
+// Proportional and unique set size from /proc/<pid>/smaps_rollup
+MemoryUsage processMemoryUsage(qint64 pid);
+
+QList<qint64> descendantProcesses(qint64 pid);
+QByteArray processCommandLine(qint64 pid);
+
+// RSS of the process and all of its descendants in kB
+qint64 processTreeRss(qint64 pid);
+
+double percentile(const QVector<double> &sorted, double p);
+
+} // namespace bench
+
+#endif // BENCHHARNESS_H
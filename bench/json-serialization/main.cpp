@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/*
+ * Compares the serialization paths used for the service and bridge messages:
+ * the indented QJsonDocument output the code used before, compact
+ * QJsonDocument output and the streaming JsonWriter.
+ *
+ * Usage: webappmanager-json-bench [iterations]
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <stdio.h>
+
+#include "jsonwriter.h"
+
+using luna::JsonWriter;
+
+namespace
+{
+
+const int DEFAULT_ITERATIONS = 100000;
+const int RUNNING_APPS = 12;
+
+QJsonObject launchResponseObject()
+{
+    QJsonObject response;
+    response.insert("returnValue", true);
+    response.insert("processId", (qint64) 1042);
+    return response;
+}
+
+void launchResponseWriter(JsonWriter &writer)
+{
+    writer.beginObject();
+    writer.member("returnValue", true);
+    writer.member("processId", (qint64) 1042);
+    writer.endObject();
+}
+
+QJsonObject appEventObject()
+{
+    QJsonObject event;
+    event.insert("event", QString("start"));
+    event.insert("appId", QString("org.webosports.app.settings"));
+    event.insert("processId", (qint64) 1042);
+    return event;
+}
+
+void appEventWriter(JsonWriter &writer)
+{
+    writer.beginObject();
+    writer.member("event", "start");
+    writer.member("appId", QString("org.webosports.app.settings"));
+    writer.member("processId", (qint64) 1042);
+    writer.endObject();
+}
+
+QJsonObject runningAppsObject()
+{
+    QJsonArray apps;
+    for (int n = 0; n < RUNNING_APPS; n++) {
+        QJsonObject app;
+        app.insert("appId", QString("org.webosports.app.test%1").arg(n));
+        app.insert("processId", (qint64) (1000 + n));
+        apps.append(app);
+    }
+
+    QJsonObject root;
+    root.insert("apps", apps);
+    return root;
+}
+
+void runningAppsWriter(JsonWriter &writer)
+{
+    writer.beginObject();
+    writer.key("apps").beginArray();
+    for (int n = 0; n < RUNNING_APPS; n++) {
+        writer.beginObject();
+        writer.member("appId", QString("org.webosports.app.test%1").arg(n));
+        writer.member("processId", (qint64) (1000 + n));
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+QJsonObject activityCreateObject()
+{
+    QJsonObject type;
+    type.insert("foreground", true);
+
+    QJsonObject activity;
+    activity.insert("name", QString("org.webosports.app.settings"));
+    activity.insert("description", QString("1042"));
+    activity.insert("type", type);
+
+    QJsonObject request;
+    request.insert("activity", activity);
+    request.insert("subscribe", true);
+    request.insert("start", true);
+    request.insert("replace", true);
+    return request;
+}
+
+void activityCreateWriter(JsonWriter &writer)
+{
+    writer.beginObject();
+    writer.key("activity").beginObject();
+    writer.member("name", QString("org.webosports.app.settings"));
+    writer.member("description", QString("1042"));
+    writer.key("type").beginObject();
+    writer.member("foreground", true);
+    writer.endObject();
+    writer.endObject();
+    writer.member("subscribe", true);
+    writer.member("start", true);
+    writer.member("replace", true);
+    writer.endObject();
+}
+
+QJsonObject deviceInfoObject()
+{
+    QJsonObject root;
+    root.insert("modelName", QString("Nexus 4"));
+    root.insert("modelNameAscii", QString("Nexus 4"));
+    root.insert("platformVersion", QString("0.2.0"));
+    root.insert("platformVersionMajor", 0);
+    root.insert("platformVersionMinor", 2);
+    root.insert("platformVersionDot", 0);
+    root.insert("carrierName", QString("webOS Ports"));
+    root.insert("serialNumber", QString("00A1B2C3D4E5"));
+    root.insert("wifiAvailable", true);
+    root.insert("bluetoothAvailable", true);
+    root.insert("carrierAvailable", false);
+    root.insert("swappableBattery", false);
+    root.insert("dockModeEnabled", true);
+    return root;
+}
+
+void deviceInfoWriter(JsonWriter &writer)
+{
+    writer.beginObject();
+    writer.member("modelName", "Nexus 4");
+    writer.member("modelNameAscii", "Nexus 4");
+    writer.member("platformVersion", "0.2.0");
+    writer.member("platformVersionMajor", 0);
+    writer.member("platformVersionMinor", 2);
+    writer.member("platformVersionDot", 0);
+    writer.member("carrierName", "webOS Ports");
+    writer.member("serialNumber", "00A1B2C3D4E5");
+    writer.member("wifiAvailable", true);
+    writer.member("bluetoothAvailable", true);
+    writer.member("carrierAvailable", false);
+    writer.member("swappableBattery", false);
+    writer.member("dockModeEnabled", true);
+    writer.endObject();
+}
+
+struct Message
+{
+    const char *name;
+    QJsonObject (*buildObject)();
+    void (*write)(JsonWriter &writer);
+};
+
+const Message messages[] = {
+    { "launchApp response", launchResponseObject, launchResponseWriter },
+    { "app event", appEventObject, appEventWriter },
+    { "listRunningApps response", runningAppsObject, runningAppsWriter },
+    { "activity create", activityCreateObject, activityCreateWriter },
+    { "device info", deviceInfoObject, deviceInfoWriter },
+};
+
+// keeps the compiler from dropping the loops below
+volatile int sink = 0;
+
+double benchDocument(const Message &message, QJsonDocument::JsonFormat format, int iterations, int *size)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int n = 0; n < iterations; n++) {
+        QByteArray payload = QJsonDocument(message.buildObject()).toJson(format);
+        sink += payload.size();
+        *size = payload.size();
+    }
+
+    return timer.nsecsElapsed() / (double) iterations;
+}
+
+double benchWriter(const Message &message, int iterations, int *size)
+{
+    QByteArray buffer;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int n = 0; n < iterations; n++) {
+        JsonWriter writer(&buffer);
+        message.write(writer);
+        sink += writer.size();
+        *size = writer.size();
+    }
+
+    return timer.nsecsElapsed() / (double) iterations;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    int iterations = DEFAULT_ITERATIONS;
+    QStringList arguments = app.arguments();
+    if (arguments.size() > 1)
+        iterations = qMax(1, arguments.at(1).toInt());
+
+    printf("%-26s %-10s %8s %12s\n", "message", "method", "bytes", "ns/message");
+
+    for (const Message &message : messages) {
+        // the writer output has to stay equivalent to what it replaces
+        JsonWriter check;
+        message.write(check);
+        if (QJsonDocument::fromJson(check.data()).object() != message.buildObject()) {
+            fprintf(stderr, "%s: JsonWriter output differs: %s\n", message.name, check.constData());
+            return 1;
+        }
+
+        int size = 0;
+        double elapsed;
+
+        elapsed = benchDocument(message, QJsonDocument::Indented, iterations, &size);
+        printf("%-26s %-10s %8d %12.1f\n", message.name, "indented", size, elapsed);
+
+        elapsed = benchDocument(message, QJsonDocument::Compact, iterations, &size);
+        printf("%-26s %-10s %8d %12.1f\n", message.name, "compact", size, elapsed);
+
+        elapsed = benchWriter(message, iterations, &size);
+        printf("%-26s %-10s %8d %12.1f\n", message.name, "writer", size, elapsed);
+    }
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/*
+ * Launches and kills synthetic applications through the web app manager
+ * service and reports how long they take to reach stageReady.
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QVector>
+
+#include <stdio.h>
+#include <algorithm>
+
+#include "benchharness.h"
+#include "jsonwriter.h"
+
+using luna::JsonWriter;
+
+namespace
+{
+
+const int STAGE_READY_TIMEOUT_MSEC = 10000;
+const int CLOSE_TIMEOUT_MSEC = 5000;
+
+const char *syntheticPage =
+    "<!DOCTYPE html>\n"
+    "<html><head><script>\n"
+    "window.addEventListener('load', function() { PalmSystem.stageReady(); });\n"
+    "</script></head><body></body></html>\n";
+
+int measureLaunches(bench::Harness &harness, const QString &page, int count, bool json)
+{
+    LS::Call events = harness.handle().callMultiReply("luna://org.webosports.webappmanager/registerForAppEvents",
+                                                      "{\"subscribe\":true}");
+    LS::Message subscribed = events.get(bench::STARTUP_TIMEOUT_MSEC);
+    if (!subscribed || !bench::parseReply(subscribed).value("returnValue").toBool()) {
+        fprintf(stderr, "Failed to subscribe for app events\n");
+        return 1;
+    }
+
+    qint64 rssBefore = bench::processTreeRss(harness.managerPid());
+
+    QVector<double> stageReadyTimes;
+    int failures = 0;
+    QElapsedTimer total;
+    total.start();
+
+    for (int n = 0; n < count; n++) {
+        QString appId = QString("org.webosports.bench.launch%1").arg(n);
+
+        QElapsedTimer launch;
+        launch.start();
+
+        if (!harness.launchApp(appId, page, 1000 + n) ||
+            !bench::waitForAppEvent(events, "stageReady", appId, STAGE_READY_TIMEOUT_MSEC))
+            failures++;
+        else
+            stageReadyTimes.append(launch.nsecsElapsed() / 1000000.0);
+
+        harness.killApp(appId);
+        bench::waitForAppEvent(events, "close", appId, CLOSE_TIMEOUT_MSEC);
+    }
+
+    double elapsed = total.nsecsElapsed() / 1000000000.0;
+    qint64 rssAfter = bench::processTreeRss(harness.managerPid());
+
+    std::sort(stageReadyTimes.begin(), stageReadyTimes.end());
+
+    if (json) {
+        JsonWriter output;
+        output.beginObject();
+        output.member("launches", count);
+        output.member("failures", failures);
+        output.key("stageReadyMsec").beginObject();
+        output.member("p50", bench::percentile(stageReadyTimes, 0.50));
+        output.member("p95", bench::percentile(stageReadyTimes, 0.95));
+        output.member("p99", bench::percentile(stageReadyTimes, 0.99));
+        output.endObject();
+        output.member("launchesPerSecond", count / elapsed);
+        output.member("rssBeforeKb", rssBefore);
+        output.member("rssAfterKb", rssAfter);
+        output.member("rssGrowthKb", rssAfter - rssBefore);
+        output.endObject();
+        printf("%s\n", output.constData());
+    }
+    else {
+        printf("launches:          %d (%d failed)\n", count, failures);
+        printf("stageReady p50:    %.1f ms\n", bench::percentile(stageReadyTimes, 0.50));
+        printf("stageReady p95:    %.1f ms\n", bench::percentile(stageReadyTimes, 0.95));
+        printf("stageReady p99:    %.1f ms\n", bench::percentile(stageReadyTimes, 0.99));
+        printf("launches/second:   %.2f\n", count / elapsed);
+        printf("RSS growth:        %lld kB (%lld -> %lld kB)\n",
+               rssAfter - rssBefore, rssBefore, rssAfter);
+    }
+
+    return failures > 0 ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures web application launch times");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption(QStringList() << "n" << "count",
+                                        "Number of applications to launch", "count", "20"));
+    parser.addOption(QCommandLineOption("json", "Print the results as JSON"));
+    bench::Harness::addOptions(parser);
+    parser.process(app);
+
+    int count = qMax(1, parser.value("count").toInt());
+
+    QTemporaryDir appDir;
+    QFile page(appDir.path() + "/index.html");
+    if (!appDir.isValid() || !page.open(QIODevice::WriteOnly)) {
+        fprintf(stderr, "Failed to create the synthetic application\n");
+        return 1;
+    }
+    page.write(syntheticPage);
+    page.close();
+
+    bench::Harness harness;
+    if (!harness.start(parser))
+        return 1;
+
+    int result = 1;
+
+    try {
+        result = measureLaunches(harness, page.fileName(), count, parser.isSet("json"));
+    }
+    catch (LS::Error &error) {
+        fprintf(stderr, "Benchmark failed: %s\n", error.what());
+    }
+
+    return result;
+}
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/*
+ * Load generator for the web app manager service. Keeps a configurable
+ * number of requests in flight against isAppRunning, listRunningApps,
+ * relaunch, clearMemoryCaches and registerForAppEvents and records their
+ * latency, first with no cards open and then while cards keep rendering.
+ * The service handle shares the GUI thread's main context, so the
+ * difference between both phases is the delay rendering adds.
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QVector>
+
+#include <glib.h>
+#include <stdio.h>
+#include <algorithm>
+
+#include "benchharness.h"
+#include "jsonwriter.h"
+
+using luna::JsonWriter;
+
+namespace
+{
+
+const int STAGE_READY_TIMEOUT_MSEC = 10000;
+
+// keeps the compositor and the renderer busy for as long as the card is open
+const char *renderingPage =
+    "<!DOCTYPE html>\n"
+    "<html><head><script>\n"
+    "window.addEventListener('load', function() {\n"
+    "    var canvas = document.getElementById('canvas');\n"
+    "    var context = canvas.getContext('2d');\n"
+    "    var frame = 0;\n"
+    "    function draw() {\n"
+    "        frame++;\n"
+    "        for (var n = 0; n < 500; n++) {\n"
+    "            context.fillStyle = 'hsl(' + ((frame + n) % 360) + ',80%,50%)';\n"
+    "            context.fillRect((n * 37 + frame) % canvas.width, (n * 53 + frame) % canvas.height, 40, 40);\n"
+    "        }\n"
+    "        window.requestAnimationFrame(draw);\n"
+    "    }\n"
+    "    draw();\n"
+    "    PalmSystem.stageReady();\n"
+    "});\n"
+    "</script></head>\n"
+    "<body style='margin:0'><canvas id='canvas' width='1024' height='768'></canvas></body></html>\n";
+
+struct Method
+{
+    const char *name;
+    const char *uri;
+    QByteArray payload;
+    bool subscription;
+
+    QVector<double> latencies;
+    int errors;
+};
+
+struct Slot;
+
+struct LoadGenerator
+{
+    QVector<Method> methods;
+    QVector<Slot*> requests;
+    LS::Handle *handle;
+    GMainLoop *mainLoop;
+    bool running;
+    int nextMethod;
+};
+
+struct Slot
+{
+    LoadGenerator *generator;
+    Method *method;
+    QScopedPointer<LS::Call> call;
+    QElapsedTimer timer;
+    guint restartSource;
+};
+
+void issueRequest(Slot *slot);
+
+gboolean restartSlot(gpointer data)
+{
+    Slot *slot = static_cast<Slot*>(data);
+    slot->restartSource = 0;
+
+    // drops the previous call, which also ends a subscription
+    slot->call.reset();
+
+    if (slot->generator->running)
+        issueRequest(slot);
+
+    return G_SOURCE_REMOVE;
+}
+
+bool handleReply(LSHandle *handle, LSMessage *message, void *context)
+{
+    Slot *slot = static_cast<Slot*>(context);
+
+    // only the first reply counts, later ones are subscription events
+    if (slot->restartSource)
+        return true;
+
+    slot->method->latencies.append(slot->timer.nsecsElapsed() / 1000000.0);
+
+    LS::Message reply(message);
+    if (reply.isHubError() || !bench::parseReply(reply).value("returnValue").toBool(true))
+        slot->method->errors++;
+
+    slot->restartSource = g_idle_add(restartSlot, slot);
+
+    return true;
+}
+
+void issueRequest(Slot *slot)
+{
+    LoadGenerator *generator = slot->generator;
+
+    // every slot walks through all methods so each sees the same concurrency
+    slot->method = &generator->methods[generator->nextMethod];
+    generator->nextMethod = (generator->nextMethod + 1) % generator->methods.size();
+
+    slot->timer.start();
+
+    try {
+        if (slot->method->subscription)
+            slot->call.reset(new LS::Call(generator->handle->callMultiReply(slot->method->uri,
+                                                                            slot->method->payload.constData(),
+                                                                            handleReply, slot)));
+        else
+            slot->call.reset(new LS::Call(generator->handle->callOneReply(slot->method->uri,
+                                                                          slot->method->payload.constData(),
+                                                                          handleReply, slot)));
+    }
+    catch (LS::Error &error) {
+        slot->method->errors++;
+        slot->restartSource = g_idle_add(restartSlot, slot);
+    }
+}
+
+gboolean stopGenerator(gpointer data)
+{
+    LoadGenerator *generator = static_cast<LoadGenerator*>(data);
+    generator->running = false;
+    g_main_loop_quit(generator->mainLoop);
+    return G_SOURCE_REMOVE;
+}
+
+QVector<Method> createMethods(const QStringList &selected, const QString &relaunchAppId)
+{
+    QByteArray appIdPayload = QByteArray("{\"appId\":\"") + relaunchAppId.toUtf8() + "\"}";
+
+    Method all[] = {
+        { "isAppRunning", "luna://org.webosports.webappmanager/isAppRunning", appIdPayload, false, QVector<double>(), 0 },
+        { "listRunningApps", "luna://org.webosports.webappmanager/listRunningApps", "{}", false, QVector<double>(), 0 },
+        { "relaunch", "luna://org.webosports.webappmanager/relaunch", appIdPayload, false, QVector<double>(), 0 },
+        { "clearMemoryCaches", "luna://org.webosports.webappmanager/clearMemoryCaches", "{}", false, QVector<double>(), 0 },
+        { "registerForAppEvents", "luna://org.webosports.webappmanager/registerForAppEvents",
+          "{\"subscribe\":true}", true, QVector<double>(), 0 },
+    };
+
+    QVector<Method> methods;
+    for (const Method &method : all) {
+        if (selected.isEmpty() || selected.contains(method.name))
+            methods.append(method);
+    }
+
+    return methods;
+}
+
+QVector<Method> runPhase(LS::Handle &handle, const QVector<Method> &methods, int concurrency, int duration)
+{
+    LoadGenerator generator;
+    generator.methods = methods;
+    generator.handle = &handle;
+    generator.mainLoop = g_main_loop_new(g_main_context_default(), FALSE);
+    generator.running = true;
+    generator.nextMethod = 0;
+
+    for (int n = 0; n < concurrency; n++) {
+        Slot *slot = new Slot;
+        slot->generator = &generator;
+        slot->method = 0;
+        slot->restartSource = 0;
+        generator.requests.append(slot);
+        issueRequest(slot);
+    }
+
+    g_timeout_add(duration, stopGenerator, &generator);
+    g_main_loop_run(generator.mainLoop);
+
+    Q_FOREACH(Slot *slot, generator.requests) {
+        if (slot->restartSource)
+            g_source_remove(slot->restartSource);
+        delete slot;
+    }
+    g_main_loop_unref(generator.mainLoop);
+
+    return generator.methods;
+}
+
+void writePhase(JsonWriter &output, const char *name, QVector<Method> &methods, int duration)
+{
+    output.key(name).beginObject();
+    for (Method &method : methods) {
+        std::sort(method.latencies.begin(), method.latencies.end());
+
+        output.key(method.name).beginObject();
+        output.member("requests", method.latencies.size());
+        output.member("errors", method.errors);
+        output.member("perSecond", method.latencies.size() * 1000.0 / duration);
+        output.member("p50Ms", bench::percentile(method.latencies, 0.50));
+        output.member("p95Ms", bench::percentile(method.latencies, 0.95));
+        output.member("p99Ms", bench::percentile(method.latencies, 0.99));
+        output.member("maxMs", method.latencies.isEmpty() ? 0.0 : method.latencies.last());
+        output.endObject();
+    }
+    output.endObject();
+}
+
+void printPhase(const char *name, QVector<Method> &methods, int duration)
+{
+    printf("%s\n", name);
+    printf("  %-22s %8s %6s %8s %8s %8s %8s\n", "method", "req/s", "errors", "p50 ms", "p95 ms", "p99 ms", "max ms");
+
+    for (Method &method : methods) {
+        std::sort(method.latencies.begin(), method.latencies.end());
+
+        printf("  %-22s %8.1f %6d %8.2f %8.2f %8.2f %8.2f\n", method.name,
+               method.latencies.size() * 1000.0 / duration, method.errors,
+               bench::percentile(method.latencies, 0.50),
+               bench::percentile(method.latencies, 0.95),
+               bench::percentile(method.latencies, 0.99),
+               method.latencies.isEmpty() ? 0.0 : method.latencies.last());
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures web app manager service latency under load");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption(QStringList() << "c" << "concurrency",
+                                        "Requests kept in flight", "count", "8"));
+    parser.addOption(QCommandLineOption(QStringList() << "d" << "duration",
+                                        "Seconds per phase", "seconds", "10"));
+    parser.addOption(QCommandLineOption("cards", "Rendering cards open in the second phase", "count", "3"));
+    parser.addOption(QCommandLineOption("methods", "Comma separated methods to call (default: all)", "names"));
+    parser.addOption(QCommandLineOption("json", "Print the results as JSON"));
+    bench::Harness::addOptions(parser);
+    parser.process(app);
+
+    int concurrency = qMax(1, parser.value("concurrency").toInt());
+    int duration = qMax(1, parser.value("duration").toInt()) * 1000;
+    int cards = qMax(0, parser.value("cards").toInt());
+
+    QStringList selected;
+    if (parser.isSet("methods"))
+        selected = parser.value("methods").split(',', QString::SkipEmptyParts);
+
+    QVector<Method> methods = createMethods(selected, "org.webosports.bench.load0");
+    if (methods.isEmpty()) {
+        fprintf(stderr, "No known method selected\n");
+        return 1;
+    }
+
+    QTemporaryDir appDir;
+    QFile page(appDir.path() + "/index.html");
+    if (!appDir.isValid() || !page.open(QIODevice::WriteOnly)) {
+        fprintf(stderr, "Failed to create the card application\n");
+        return 1;
+    }
+    page.write(renderingPage);
+    page.close();
+
+    bench::Harness harness;
+    if (!harness.start(parser))
+        return 1;
+
+    try {
+        QVector<Method> idle = runPhase(harness.handle(), methods, concurrency, duration);
+
+        LS::Call events = harness.handle().callMultiReply("luna://org.webosports.webappmanager/registerForAppEvents",
+                                                          "{\"subscribe\":true}");
+        events.get(bench::STARTUP_TIMEOUT_MSEC);
+
+        for (int n = 0; n < cards; n++) {
+            QString appId = QString("org.webosports.bench.load%1").arg(n);
+            if (!harness.launchApp(appId, page.fileName(), 1000 + n) ||
+                !bench::waitForAppEvent(events, "stageReady", appId, STAGE_READY_TIMEOUT_MSEC)) {
+                fprintf(stderr, "Failed to launch %s\n", qPrintable(appId));
+                return 1;
+            }
+        }
+
+        QVector<Method> rendering = runPhase(harness.handle(), methods, concurrency, duration);
+
+        if (parser.isSet("json")) {
+            JsonWriter output;
+            output.beginObject();
+            output.member("concurrency", concurrency);
+            output.member("durationMsec", duration);
+            output.member("cards", cards);
+            writePhase(output, "idle", idle, duration);
+            writePhase(output, "rendering", rendering, duration);
+            output.endObject();
+            printf("%s\n", output.constData());
+        }
+        else {
+            printf("concurrency %d, %d ms per phase, %d rendering cards\n", concurrency, duration, cards);
+            printPhase("idle", idle, duration);
+            printPhase("rendering", rendering, duration);
+        }
+    }
+    catch (LS::Error &error) {
+        fprintf(stderr, "Benchmark failed: %s\n", error.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/*
+ * Opens card windows one by one and records PSS/USS of the manager and its
+ * QtWebEngine renderers after each step, then closes them again to see how
+ * much memory comes back. System scope apps are loaded from file://, remote
+ * scope apps from a local HTTP server.
+ */
+
+#include <QAtomicInt>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QSemaphore>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "benchharness.h"
+#include "jsonwriter.h"
+
+using luna::JsonWriter;
+using bench::MemoryUsage;
+
+namespace
+{
+
+const int STAGE_READY_TIMEOUT_MSEC = 10000;
+const int CLOSE_TIMEOUT_MSEC = 5000;
+
+const char *cardPage =
+    "<!DOCTYPE html>\n"
+    "<html><head><script>\n"
+    "window.addEventListener('load', function() { PalmSystem.stageReady(); });\n"
+    "</script></head><body><h1>Card</h1></body></html>\n";
+
+// Serves the card page for any request. Runs its own blocking accept loop
+// as the main thread sits in bus calls most of the time.
+class PageServer : public QThread
+{
+public:
+    PageServer() : mPort(0) {}
+
+    ~PageServer()
+    {
+        mStop.store(1);
+        wait();
+    }
+
+    quint16 start()
+    {
+        QThread::start();
+        mListening.acquire();
+        return mPort;
+    }
+
+protected:
+    void run()
+    {
+        QTcpServer server;
+        if (server.listen(QHostAddress::LocalHost))
+            mPort = server.serverPort();
+        mListening.release();
+
+        QByteArray response = QByteArray("HTTP/1.0 200 OK\r\n"
+                                         "Content-Type: text/html\r\n"
+                                         "Connection: close\r\n"
+                                         "Content-Length: ") +
+                              QByteArray::number((int) strlen(cardPage)) + "\r\n\r\n" + cardPage;
+
+        while (mPort && !mStop.load()) {
+            if (!server.waitForNewConnection(100))
+                continue;
+
+            QTcpSocket *socket = server.nextPendingConnection();
+            if (socket->waitForReadyRead(1000)) {
+                socket->readAll();
+                socket->write(response);
+                socket->waitForBytesWritten(1000);
+            }
+            socket->disconnectFromHost();
+            delete socket;
+        }
+    }
+
+private:
+    quint16 mPort;
+    QSemaphore mListening;
+    QAtomicInt mStop;
+};
+
+struct Snapshot
+{
+    MemoryUsage manager;
+    MemoryUsage renderers;
+    QHash<qint64, MemoryUsage> rendererByPid;
+};
+
+Snapshot takeSnapshot(qint64 managerPid, int settle)
+{
+    // give the renderers time to finish loading and the allocators to return memory
+    QThread::msleep(settle);
+
+    Snapshot snapshot;
+    snapshot.manager = bench::processMemoryUsage(managerPid);
+
+    Q_FOREACH(qint64 pid, bench::descendantProcesses(managerPid)) {
+        if (!bench::processCommandLine(pid).contains("--type=renderer"))
+            continue;
+
+        MemoryUsage usage = bench::processMemoryUsage(pid);
+        snapshot.rendererByPid.insert(pid, usage);
+        snapshot.renderers += usage;
+    }
+
+    return snapshot;
+}
+
+void writeUsage(JsonWriter &output, const char *name, const MemoryUsage &usage)
+{
+    output.key(name).beginObject();
+    output.member("pssKb", usage.pss);
+    output.member("ussKb", usage.uss);
+    output.endObject();
+}
+
+MemoryUsage difference(const MemoryUsage &after, const MemoryUsage &before)
+{
+    MemoryUsage usage;
+    usage.pss = after.pss - before.pss;
+    usage.uss = after.uss - before.uss;
+    return usage;
+}
+
+void writeSnapshot(JsonWriter &output, const Snapshot &snapshot)
+{
+    writeUsage(output, "manager", snapshot.manager);
+    writeUsage(output, "renderers", snapshot.renderers);
+    output.member("rendererCount", snapshot.rendererByPid.size());
+}
+
+void printUsage(const char *label, const MemoryUsage &usage)
+{
+    printf("  %-22s PSS %8lld kB  USS %8lld kB\n", label, usage.pss, usage.uss);
+}
+
+int measureCards(bench::Harness &harness, const QString &systemPage, quint16 serverPort,
+                 int systemCount, int remoteCount, int settle, bool json)
+{
+    LS::Call events = harness.handle().callMultiReply("luna://org.webosports.webappmanager/registerForAppEvents",
+                                                      "{\"subscribe\":true}");
+    LS::Message subscribed = events.get(bench::STARTUP_TIMEOUT_MSEC);
+    if (!subscribed || !bench::parseReply(subscribed).value("returnValue").toBool()) {
+        fprintf(stderr, "Failed to subscribe for app events\n");
+        return 1;
+    }
+
+    qint64 managerPid = harness.managerPid();
+    Snapshot baseline = takeSnapshot(managerPid, settle);
+    Snapshot previous = baseline;
+    QStringList appIds;
+    int failures = 0;
+
+    JsonWriter output;
+    output.beginObject();
+    output.key("baseline").beginObject();
+    writeSnapshot(output, baseline);
+    output.endObject();
+
+    if (!json) {
+        printf("baseline\n");
+        printUsage("manager", baseline.manager);
+        printUsage("renderers", baseline.renderers);
+    }
+
+    output.key("launches").beginArray();
+    for (int n = 0; n < systemCount + remoteCount; n++) {
+        bool remote = n >= systemCount;
+        QString appId = QString("org.webosports.bench.card%1").arg(n);
+        QString main = remote ? QString("http://127.0.0.1:%1/index.html").arg(serverPort) : systemPage;
+
+        if (!harness.launchApp(appId, main, 1000 + n) ||
+            !bench::waitForAppEvent(events, "stageReady", appId, STAGE_READY_TIMEOUT_MSEC)) {
+            fprintf(stderr, "Failed to launch %s\n", qPrintable(appId));
+            failures++;
+            continue;
+        }
+
+        appIds.append(appId);
+        Snapshot current = takeSnapshot(managerPid, settle);
+
+        // renderers which were not there before belong to this app
+        MemoryUsage appRenderers;
+        QList<qint64> newRenderers;
+        Q_FOREACH(qint64 pid, current.rendererByPid.keys()) {
+            if (!previous.rendererByPid.contains(pid)) {
+                appRenderers += current.rendererByPid.value(pid);
+                newRenderers.append(pid);
+            }
+        }
+
+        MemoryUsage managerGrowth = difference(current.manager, previous.manager);
+        MemoryUsage total = managerGrowth;
+        total += appRenderers;
+
+        output.beginObject();
+        output.member("appId", appId);
+        output.member("scope", remote ? "remote" : "system");
+        writeUsage(output, "managerGrowth", managerGrowth);
+        writeUsage(output, "appRenderers", appRenderers);
+        writeUsage(output, "total", total);
+        output.key("rendererPids").beginArray();
+        Q_FOREACH(qint64 pid, newRenderers)
+            output.value(pid);
+        output.endArray();
+        writeSnapshot(output, current);
+        output.endObject();
+
+        if (!json) {
+            printf("%s (%s)\n", qPrintable(appId), remote ? "remote" : "system");
+            printUsage("manager growth", managerGrowth);
+            printUsage("app renderers", appRenderers);
+            printUsage("per card", total);
+        }
+
+        previous = current;
+    }
+    output.endArray();
+
+    Snapshot peak = previous;
+
+    output.key("closes").beginArray();
+    Q_FOREACH(const QString &appId, appIds) {
+        harness.killApp(appId);
+        if (!bench::waitForAppEvent(events, "close", appId, CLOSE_TIMEOUT_MSEC))
+            fprintf(stderr, "%s did not close\n", qPrintable(appId));
+
+        Snapshot current = takeSnapshot(managerPid, settle);
+
+        output.beginObject();
+        output.member("appId", appId);
+        writeUsage(output, "managerReturned", difference(previous.manager, current.manager));
+        writeUsage(output, "renderersReturned", difference(previous.renderers, current.renderers));
+        writeSnapshot(output, current);
+        output.endObject();
+
+        previous = current;
+    }
+    output.endArray();
+
+    // whatever is left above the baseline after closing everything is a leak candidate
+    MemoryUsage managerResidual = difference(previous.manager, baseline.manager);
+    MemoryUsage rendererResidual = difference(previous.renderers, baseline.renderers);
+
+    output.key("returned").beginObject();
+    writeUsage(output, "manager", difference(peak.manager, previous.manager));
+    writeUsage(output, "renderers", difference(peak.renderers, previous.renderers));
+    output.endObject();
+    output.key("residual").beginObject();
+    writeUsage(output, "manager", managerResidual);
+    writeUsage(output, "renderers", rendererResidual);
+    output.member("rendererCount", previous.rendererByPid.size() - baseline.rendererByPid.size());
+    output.endObject();
+    output.member("failures", failures);
+    output.endObject();
+
+    if (json) {
+        printf("%s\n", output.constData());
+    }
+    else {
+        printf("after closing %d cards\n", appIds.size());
+        printUsage("manager returned", difference(peak.manager, previous.manager));
+        printUsage("renderers returned", difference(peak.renderers, previous.renderers));
+        printUsage("manager residual", managerResidual);
+        printUsage("renderer residual", rendererResidual);
+    }
+
+    return failures > 0 ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures the memory cost of card windows");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("system", "Number of system scope (file://) cards", "count", "5"));
+    parser.addOption(QCommandLineOption("remote", "Number of remote scope (http://) cards", "count", "5"));
+    parser.addOption(QCommandLineOption("settle", "Milliseconds to wait before each sample", "msec", "2000"));
+    parser.addOption(QCommandLineOption("json", "Print the results as JSON"));
+    bench::Harness::addOptions(parser);
+    parser.process(app);
+
+    QTemporaryDir appDir;
+    QFile page(appDir.path() + "/index.html");
+    if (!appDir.isValid() || !page.open(QIODevice::WriteOnly)) {
+        fprintf(stderr, "Failed to create the card application\n");
+        return 1;
+    }
+    page.write(cardPage);
+    page.close();
+
+    PageServer server;
+    quint16 serverPort = server.start();
+    if (!serverPort) {
+        fprintf(stderr, "Failed to start the HTTP server\n");
+        return 1;
+    }
+
+    bench::Harness harness;
+    if (!harness.start(parser))
+        return 1;
+
+    int result = 1;
+
+    try {
+        result = measureCards(harness, page.fileName(), serverPort,
+                              qMax(0, parser.value("system").toInt()),
+                              qMax(0, parser.value("remote").toInt()),
+                              qMax(0, parser.value("settle").toInt()),
+                              parser.isSet("json"));
+    }
+    catch (LS::Error &error) {
+        fprintf(stderr, "Benchmark failed: %s\n", error.what());
+    }
+
+    return result;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+/*
+ * Stand-in for the system services the web app manager talks to while
+ * launching applications. It answers with canned responses so benchmarks
+ * measure the manager itself and not the services behind it.
+ *
+ * It needs a luna-service2 hub to register on; run it against a private
+ * ls-hubd on a development host. Prints "ready" once all names are
+ * registered.
+ */
+
+#include <glib.h>
+#include <stdio.h>
+
+#include <luna-service2/lunaservice.hpp>
+
+class ApplicationManagerStandin : private LS::Handle
+{
+public:
+    ApplicationManagerStandin(GMainLoop *mainLoop)
+        : LS::Handle(LS::registerService("com.palm.applicationManager", false))
+    {
+        attachToLoop(mainLoop);
+
+        LS_CATEGORY_BEGIN(ApplicationManagerStandin, "/")
+            LS_CATEGORY_METHOD(dumpMimeTable)
+            LS_CATEGORY_METHOD(open)
+        LS_CATEGORY_END
+    }
+
+private:
+    bool dumpMimeTable(LSMessage &message)
+    {
+        LS::Message request(&message);
+        request.respond("{\"returnValue\":true,\"redirects\":[],\"resources\":[]}");
+        return true;
+    }
+
+    bool open(LSMessage &message)
+    {
+        LS::Message request(&message);
+        request.respond("{\"returnValue\":true}");
+        return true;
+    }
+};
+
+class ActivityManagerStandin : private LS::Handle
+{
+public:
+    ActivityManagerStandin(GMainLoop *mainLoop)
+        : LS::Handle(LS::registerService("com.palm.activitymanager", false)),
+          mNextActivityId(1)
+    {
+        attachToLoop(mainLoop);
+
+        LS_CATEGORY_BEGIN(ActivityManagerStandin, "/")
+            LS_CATEGORY_METHOD(create)
+            LS_CATEGORY_METHOD(focus)
+            LS_CATEGORY_METHOD(unfocus)
+        LS_CATEGORY_END
+    }
+
+private:
+    bool create(LSMessage &message)
+    {
+        LS::Message request(&message);
+
+        char response[64];
+        snprintf(response, sizeof(response), "{\"returnValue\":true,\"activityId\":%d}", mNextActivityId++);
+        request.respond(response);
+
+        return true;
+    }
+
+    bool focus(LSMessage &message)
+    {
+        LS::Message request(&message);
+        request.respond("{\"returnValue\":true}");
+        return true;
+    }
+
+    bool unfocus(LSMessage &message)
+    {
+        LS::Message request(&message);
+        request.respond("{\"returnValue\":true}");
+        return true;
+    }
+
+    int mNextActivityId;
+};
+
+class NotificationsStandin : private LS::Handle
+{
+public:
+    NotificationsStandin(GMainLoop *mainLoop)
+        : LS::Handle(LS::registerService("org.webosports.notifications", false)),
+          mNextNotificationId(1)
+    {
+        attachToLoop(mainLoop);
+
+        LS_CATEGORY_BEGIN(NotificationsStandin, "/")
+            LS_CATEGORY_METHOD(create)
+            LS_CATEGORY_METHOD(close)
+            LS_CATEGORY_METHOD(closeAll)
+        LS_CATEGORY_END
+    }
+
+private:
+    bool create(LSMessage &message)
+    {
+        LS::Message request(&message);
+
+        char response[64];
+        snprintf(response, sizeof(response), "{\"returnValue\":true,\"id\":%d}", mNextNotificationId++);
+        request.respond(response);
+
+        return true;
+    }
+
+    bool close(LSMessage &message)
+    {
+        LS::Message request(&message);
+        request.respond("{\"returnValue\":true}");
+        return true;
+    }
+
+    bool closeAll(LSMessage &message)
+    {
+        LS::Message request(&message);
+        request.respond("{\"returnValue\":true}");
+        return true;
+    }
+
+    int mNextNotificationId;
+};
+
+// Backs the benchmark pages: echoes payloads and hands results to the runner.
+class BenchStandin : private LS::Handle
+{
+public:
+    BenchStandin(GMainLoop *mainLoop)
+        : LS::Handle(LS::registerService("org.webosports.bench", false))
+    {
+        attachToLoop(mainLoop);
+
+        LS_CATEGORY_BEGIN(BenchStandin, "/")
+            LS_CATEGORY_METHOD(echo)
+            LS_CATEGORY_METHOD(report)
+        LS_CATEGORY_END
+    }
+
+private:
+    bool echo(LSMessage &message)
+    {
+        LS::Message request(&message);
+        request.respond(request.getPayload());
+        return true;
+    }
+
+    bool report(LSMessage &message)
+    {
+        LS::Message request(&message);
+
+        printf("report %s\n", request.getPayload());
+        fflush(stdout);
+
+        request.respond("{\"returnValue\":true}");
+        return true;
+    }
+};
+
+int main(int argc, char **argv)
+{
+    GMainLoop *mainLoop = g_main_loop_new(g_main_context_default(), FALSE);
+
+    try {
+        ApplicationManagerStandin applicationManager(mainLoop);
+        ActivityManagerStandin activityManager(mainLoop);
+        NotificationsStandin notifications(mainLoop);
+        BenchStandin bench(mainLoop);
+
+        printf("ready\n");
+        fflush(stdout);
+
+        g_main_loop_run(mainLoop);
+    }
+    catch (LS::Error &error) {
+        fprintf(stderr, "Failed to register stand-in services: %s\n", error.what());
+        return 1;
+    }
+
+    g_main_loop_unref(mainLoop);
+
+    return 0;
+}
@@ -15,9 +15,37 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>
  */
 
+#include <QList>
+#include <QPair>
+
 #include "baseextension.h"
 #include "applicationenvironment.h"
 
+// a page never listening must not make us hold every event forever
+#define MAX_PENDING_EVENTS 64
+
+namespace luna
+{
+
+class BaseExtensionPrivate : public QObject
+{
+public:
+    explicit BaseExtensionPrivate(QObject *parent) :
+        QObject(parent),
+        eventsEnabled(false),
+        resyncNeeded(false)
+    {
+        setObjectName(QStringLiteral("_baseExtensionPrivate"));
+    }
+
+    bool eventsEnabled;
+    // the queue overflowed, the page gets the complete state instead
+    bool resyncNeeded;
+    QList<QPair<QString, QJsonArray> > pendingEvents;
+};
+
+} // namespace luna
+
 using namespace luna;
 
 BaseExtension::BaseExtension(const QString &name, ApplicationEnvironment *environment, QObject *parent) :
@@ -25,6 +53,7 @@ BaseExtension::BaseExtension(const QString &name, ApplicationEnvironment *enviro
     mAppEnvironment(environment),
     mName(name)
 {
+    new BaseExtensionPrivate(this);
 }
 
 void BaseExtension::initialize()
@@ -36,3 +65,65 @@ QString BaseExtension::name() const
     return mName;
 }
 
+BaseExtensionPrivate *BaseExtension::d_func() const
+{
+    Q_FOREACH(QObject *child, children()) {
+        if (child->objectName() == QLatin1String("_baseExtensionPrivate"))
+            return static_cast<BaseExtensionPrivate*>(child);
+    }
+
+    return 0;
+}
+
+void BaseExtension::enableEvents()
+{
+    BaseExtensionPrivate *d = d_func();
+
+    d->eventsEnabled = true;
+
+    if (d->resyncNeeded) {
+        d->resyncNeeded = false;
+        d->pendingEvents.clear();
+        initialize();
+        return;
+    }
+
+    QList<QPair<QString, QJsonArray> > events = d->pendingEvents;
+    d->pendingEvents.clear();
+
+    for (int n = 0; n < events.size(); n++)
+        emit extensionEvent(events.at(n).first, events.at(n).second);
+}
+
+void BaseExtension::holdEvents()
+{
+    BaseExtensionPrivate *d = d_func();
+
+    // the old page is gone, the new one gets the state on initialize()
+    d->eventsEnabled = false;
+    d->resyncNeeded = false;
+    d->pendingEvents.clear();
+}
+
+void BaseExtension::sendEvent(const QString &name, const QJsonArray &arguments)
+{
+    BaseExtensionPrivate *d = d_func();
+
+    if (!d->eventsEnabled) {
+        // dropping single events would leave the page with a state it can't
+        // repair, the snapshot sent on resync replaces all of them
+        if (d->resyncNeeded)
+            return;
+
+        if (d->pendingEvents.size() >= MAX_PENDING_EVENTS) {
+            d->pendingEvents.clear();
+            d->resyncNeeded = true;
+            return;
+        }
+
+        d->pendingEvents.append(qMakePair(name, arguments));
+        return;
+    }
+
+    emit extensionEvent(name, arguments);
+}
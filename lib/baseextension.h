@@ -26,6 +26,7 @@ namespace luna
 {
 
 class ApplicationEnvironment;
+class BaseExtensionPrivate;
 
 class BaseExtension : public QObject
 {
@@ -39,14 +40,33 @@ public:
 
     QString name() const;
 
+    // Called by the page once it listens to extensionEvent, the events sent
+    // before are delivered right away.
+    Q_INVOKABLE void enableEvents();
+    // A new page is loading, hold the events back until it listens again
+    void holdEvents();
+
 Q_SIGNALS:
     void callback(int id, bool keepCallback, bool success, const QString &parameters);
+    void extensionEvent(const QString &name, const QJsonArray &arguments);
 
 protected:
+    // Deliver an event to the handlers the page registered for this
+    // extension with _webOS.subscribeEvents. The arguments travel as
+    // structured data over the web channel, no script is compiled. Until the
+    // page listens the events are held back. When too many pile up they are
+    // dropped and initialize() is called once the page listens, so it has to
+    // send the complete state of the extension.
+    void sendEvent(const QString &name, const QJsonArray &arguments = QJsonArray());
+
     ApplicationEnvironment *mAppEnvironment;
 
 private:
     QString mName;
+
+    // the object layout is part of the plugin ABI, the private state hangs
+    // off the extension as a child object
+    BaseExtensionPrivate *d_func() const;
 };
 
 } // namespace luna
@@ -19,7 +19,8 @@
 #define ACTIVITY_H
 
 #include <QString>
-#include <luna-service2/lunaservice.h>
+
+#include <luna-service2++/call.hpp>
 
 namespace luna
 {
@@ -35,19 +36,16 @@ public:
     void focus();
     void unfocus();
 
-    static bool activityCallback(LSHandle *handle, LSMessage *message, void *user_data);
-
 private:
-    LSHandle *mHandle;
-    LSMessageToken mToken;
+    friend class ActivityManagerClient;
+
+    LS::Call mCall;
     int mId;
+    QString mIdentifier;
     QString mAppId;
     int64_t mProcessId;
-    QString mIdentifier;
     bool mFocus;
-
-    void setup();
-    void handleActivityResponse(LSMessage *message);
+    bool mRequestedFocus;
 };
 
 } // namespace
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <luna-service2++/message.hpp>
+
+#include "activity.h"
+#include "activitymanagerclient.h"
+#include "jsonwriter.h"
+#include "logger.h"
+
+#define ACTIVITY_MANAGER_SERVICE_ID     "com.palm.activitymanager"
+#define FOCUS_COALESCE_MSEC             100
+
+namespace luna
+{
+
+ActivityManagerClient* ActivityManagerClient::instance()
+{
+    static ActivityManagerClient* instance = 0;
+
+    if (!instance)
+        instance = new ActivityManagerClient();
+
+    return instance;
+}
+
+ActivityManagerClient::ActivityManagerClient() :
+    mHandle(NULL, false),
+    mServiceAvailable(false)
+{
+    mHandle.attachToLoop(g_main_context_default());
+
+    mFocusTimer.setSingleShot(true);
+    mFocusTimer.setInterval(FOCUS_COALESCE_MSEC);
+    connect(&mFocusTimer, SIGNAL(timeout()), this, SLOT(flushFocusChanges()));
+
+    LS::ServerStatusCallback callback = [this] (bool isActive) {
+        mServiceAvailable = isActive;
+        if (!isActive)
+            return true;
+
+        qCDebug(lcManager) << __PRETTY_FUNCTION__ << "Activity manager is up, creating"
+                 << mPendingCreates.size() << "pending activities";
+
+        QList<Activity*> pending = mPendingCreates;
+        mPendingCreates.clear();
+
+        Q_FOREACH(Activity *activity, pending)
+            sendCreate(activity);
+
+        return true;
+    };
+
+    mServerStatus = mHandle.registerServerStatus(ACTIVITY_MANAGER_SERVICE_ID, callback);
+}
+
+void ActivityManagerClient::create(Activity *activity)
+{
+    if (mServiceAvailable)
+        sendCreate(activity);
+    else
+        mPendingCreates.append(activity);
+}
+
+void ActivityManagerClient::remove(Activity *activity)
+{
+    mPendingCreates.removeAll(activity);
+    mPendingFocusChanges.removeAll(activity);
+
+    // dropping the subscription ends the activity
+    activity->mCall.cancel();
+}
+
+void ActivityManagerClient::updateFocus(Activity *activity)
+{
+    if (!mPendingFocusChanges.contains(activity))
+        mPendingFocusChanges.append(activity);
+
+    if (!mFocusTimer.isActive())
+        mFocusTimer.start();
+}
+
+void ActivityManagerClient::flushFocusChanges()
+{
+    QList<Activity*> pending = mPendingFocusChanges;
+    mPendingFocusChanges.clear();
+
+    // activities still waiting for their id are updated once it arrives
+    Q_FOREACH(Activity *activity, pending) {
+        if (activity->mId >= 0 && activity->mRequestedFocus != activity->mFocus)
+            sendFocus(activity);
+    }
+}
+
+void ActivityManagerClient::sendCreate(Activity *activity)
+{
+    JsonWriter payload;
+    payload.beginObject();
+    payload.key("activity").beginObject();
+    payload.member("name", activity->mAppId);
+    payload.member("description", QString::number((qint64) activity->mProcessId));
+    payload.key("type").beginObject();
+    payload.member("foreground", true);
+    payload.endObject();
+    payload.endObject();
+    payload.member("subscribe", true);
+    payload.member("start", true);
+    payload.member("replace", true);
+    payload.endObject();
+
+    activity->mCall = mHandle.callMultiReply("palm://com.palm.activitymanager/create", payload.constData(),
+                                             activity->mIdentifier.toUtf8().constData());
+    activity->mCall.continueWith(ActivityManagerClient::createCallback, activity);
+}
+
+void ActivityManagerClient::sendFocus(Activity *activity)
+{
+    LSError lserror;
+    LSErrorInit(&lserror);
+
+    JsonWriter payload;
+    payload.beginObject().member("activityId", activity->mId).endObject();
+
+    const char *uri = activity->mRequestedFocus ? "palm://com.palm.activitymanager/focus" :
+                                                  "palm://com.palm.activitymanager/unfocus";
+
+    if (!LSCallFromApplication(mHandle.get(), uri, payload.constData(),
+                               activity->mIdentifier.toUtf8().constData(), 0, 0, 0, &lserror)) {
+        LSErrorPrint(&lserror, stderr);
+        LSErrorFree(&lserror);
+        return;
+    }
+
+    activity->mFocus = activity->mRequestedFocus;
+}
+
+bool ActivityManagerClient::createCallback(LSHandle *handle, LSMessage *message, void *context)
+{
+    Activity *activity = static_cast<Activity*>(context);
+
+    QJsonDocument payload = QJsonDocument::fromJson(QByteArray(LSMessageGetPayload(message)));
+    if (!payload.isObject())
+        return true;
+
+    QJsonObject response = payload.object();
+
+    if (!response.value("returnValue").toBool(false) || !response.contains("activityId"))
+        return true;
+
+    activity->mId = response.value("activityId").toInt(-1);
+
+    if (activity->mRequestedFocus != activity->mFocus)
+        instance()->updateFocus(activity);
+
+    return true;
+}
+
+} // namespace luna
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef ACTIVITYMANAGERCLIENT_H
+#define ACTIVITYMANAGERCLIENT_H
+
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+#include <luna-service2++/handle.hpp>
+#include <luna-service2++/server_status.hpp>
+
+namespace luna
+{
+
+class Activity;
+
+/*
+ * Talks to the activity manager on behalf of all applications over a
+ * single bus connection.
+ *
+ * Creations are held back until the activity manager is on the bus and then
+ * sent in one go, which is what happens for the apps launched at boot. Focus
+ * changes are applied after a short delay so an app flapping between
+ * focused and unfocused only sends its final state.
+ */
+class ActivityManagerClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ActivityManagerClient* instance();
+
+    void create(Activity *activity);
+    void remove(Activity *activity);
+    void updateFocus(Activity *activity);
+
+private Q_SLOTS:
+    void flushFocusChanges();
+
+private:
+    ActivityManagerClient();
+
+    void sendCreate(Activity *activity);
+    void sendFocus(Activity *activity);
+    static bool createCallback(LSHandle *handle, LSMessage *message, void *context);
+
+private:
+    LS::Handle mHandle;
+    LS::ServerStatus mServerStatus;
+    bool mServiceAvailable;
+    QList<Activity*> mPendingCreates;
+    QList<Activity*> mPendingFocusChanges;
+    QTimer mFocusTimer;
+};
+
+} // namespace luna
+
+#endif // ACTIVITYMANAGERCLIENT_H
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <QDateTime>
+
+#include "appeventstream.h"
+#include "jsonwriter.h"
+
+#define APP_EVENTS_SUBSCRIPTION_KEY "appEvents"
+
+namespace luna
+{
+
+AppEventStream::AppEventStream(int replaySize) :
+    mHandle(0),
+    mSequence(0),
+    mReplaySize(replaySize),
+    mReplayHead(0)
+{
+    mReplay.reserve(replaySize);
+}
+
+void AppEventStream::setServiceHandle(LS::Handle *handle)
+{
+    mHandle = handle;
+}
+
+bool AppEventStream::Filter::matches(const Event &event) const
+{
+    if (!appIds.isEmpty() && !appIds.contains(event.appId))
+        return false;
+
+    if (!types.isEmpty() && !types.contains(event.type))
+        return false;
+
+    return true;
+}
+
+bool AppEventStream::subscribe(LS::Message &request, jvalue_ref params)
+{
+    Filter filter;
+    jvalue_ref value;
+
+    if (jobject_get_exists(params, j_cstr_to_buffer("appIds"), &value) && jis_array(value)) {
+        for (ssize_t n = 0; n < jarray_size(value); n++) {
+            raw_buffer appId = jstring_get_fast(jarray_get(value, n));
+            filter.appIds.insert(QString::fromUtf8(appId.m_str, appId.m_len));
+        }
+    }
+
+    if (jobject_get_exists(params, j_cstr_to_buffer("events"), &value) && jis_array(value)) {
+        for (ssize_t n = 0; n < jarray_size(value); n++) {
+            raw_buffer type = jstring_get_fast(jarray_get(value, n));
+            filter.types.insert(QByteArray(type.m_str, type.m_len));
+        }
+    }
+
+    int64_t since = -1;
+    if (jobject_get_exists(params, j_cstr_to_buffer("since"), &value) && jis_number(value))
+        jnumber_get_i64(value, &since);
+
+    LSError error;
+    LSErrorInit(&error);
+
+    if (!LSSubscriptionAdd(mHandle->get(), APP_EVENTS_SUBSCRIPTION_KEY, request.get(), &error)) {
+        LSErrorPrint(&error, stderr);
+        LSErrorFree(&error);
+        return false;
+    }
+
+    mFilters.insert(QByteArray(LSMessageGetUniqueToken(request.get())), filter);
+
+    // the replay is complete if nothing after "since" has dropped out of the
+    // ring already; a "since" from the future means we were restarted
+    qint64 oldest = mReplay.isEmpty() ? mSequence + 1 : mReplay.at(mReplayHead).sequence;
+    bool complete = since < 0 || (since + 1 >= oldest && since <= mSequence);
+
+    JsonWriter response;
+    response.beginObject();
+    response.member("returnValue", true);
+    response.member("subscribed", true);
+    response.member("sequence", mSequence);
+    if (since >= 0)
+        response.member("replayComplete", complete);
+    response.endObject();
+
+    request.respond(response.constData());
+
+    if (since < 0)
+        return true;
+
+    for (int n = 0; n < mReplay.size(); n++) {
+        const Event &event = mReplay.at((mReplayHead + n) % mReplay.size());
+        if (event.sequence > since && filter.matches(event))
+            request.respond(event.payload.constData());
+    }
+
+    return true;
+}
+
+void AppEventStream::post(const char *type, const QString &appId, int64_t processId,
+                          const QJsonObject &details)
+{
+    Event event;
+    event.sequence = ++mSequence;
+    event.type = type;
+    event.appId = appId;
+
+    JsonWriter payload(&event.payload);
+    payload.beginObject();
+    payload.member("event", type);
+    payload.member("sequence", event.sequence);
+    payload.member("timestamp", QDateTime::currentMSecsSinceEpoch());
+    payload.member("appId", appId);
+    payload.member("processId", (qint64) processId);
+    for (QJsonObject::const_iterator it = details.constBegin(); it != details.constEnd(); ++it)
+        payload.member(it.key().toUtf8().constData(), it.value());
+    payload.endObject();
+
+    if (mReplay.size() < mReplaySize) {
+        mReplay.append(event);
+    }
+    else {
+        mReplay[mReplayHead] = event;
+        mReplayHead = (mReplayHead + 1) % mReplaySize;
+    }
+
+    if (!mHandle)
+        return;
+
+    LSError error;
+    LSErrorInit(&error);
+
+    LSSubscriptionIter *iter = 0;
+    if (!LSSubscriptionAcquire(mHandle->get(), APP_EVENTS_SUBSCRIPTION_KEY, &iter, &error)) {
+        LSErrorPrint(&error, stderr);
+        LSErrorFree(&error);
+        return;
+    }
+
+    QSet<QByteArray> activeTokens;
+
+    while (LSSubscriptionHasNext(iter)) {
+        LSMessage *message = LSSubscriptionNext(iter);
+        QByteArray token(LSMessageGetUniqueToken(message));
+        activeTokens.insert(token);
+
+        QHash<QByteArray, Filter>::const_iterator filter = mFilters.constFind(token);
+        if (filter == mFilters.constEnd() || filter->matches(event))
+            reply(message, event.payload);
+    }
+
+    LSSubscriptionRelease(iter);
+
+    // forget the filters of subscribers which went away meanwhile
+    if (activeTokens.size() != mFilters.size()) {
+        QHash<QByteArray, Filter>::iterator it = mFilters.begin();
+        while (it != mFilters.end()) {
+            if (activeTokens.contains(it.key()))
+                ++it;
+            else
+                it = mFilters.erase(it);
+        }
+    }
+}
+
+void AppEventStream::reply(LSMessage *message, const QByteArray &payload)
+{
+    LSError error;
+    LSErrorInit(&error);
+
+    if (!LSMessageReply(mHandle->get(), message, payload.constData(), &error)) {
+        LSErrorPrint(&error, stderr);
+        LSErrorFree(&error);
+    }
+}
+
+} // namespace luna
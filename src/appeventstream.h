@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef APPEVENTSTREAM_H
+#define APPEVENTSTREAM_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include <luna-service2/lunaservice.hpp>
+#include <pbnjson.h>
+
+namespace luna
+{
+
+/*
+ * Application lifecycle events for the registerForAppEvents subscribers.
+ *
+ * Every event carries a sequence number and the most recent ones are kept
+ * in a ring, so a subscriber passing the last sequence it has seen gets
+ * everything it missed replayed instead of having to poll listRunningApps.
+ * Subscribers can restrict the stream to some apps and event types.
+ */
+class AppEventStream
+{
+public:
+    explicit AppEventStream(int replaySize = 256);
+
+    void setServiceHandle(LS::Handle *handle);
+
+    bool subscribe(LS::Message &request, jvalue_ref params);
+    void post(const char *type, const QString &appId, int64_t processId,
+              const QJsonObject &details = QJsonObject());
+
+    qint64 sequence() const { return mSequence; }
+
+private:
+    struct Event
+    {
+        qint64 sequence;
+        QByteArray type;
+        QString appId;
+        QByteArray payload;
+    };
+
+    struct Filter
+    {
+        QSet<QString> appIds;
+        QSet<QByteArray> types;
+
+        bool matches(const Event &event) const;
+    };
+
+    LS::Handle *mHandle;
+    qint64 mSequence;
+    int mReplaySize;
+    // ring buffer, mReplayHead is the oldest event once it is full
+    QVector<Event> mReplay;
+    int mReplayHead;
+    // keyed by the unique token of the subscription message
+    QHash<QByteArray, Filter> mFilters;
+
+    void reply(LSMessage *message, const QByteArray &payload);
+};
+
+} // namespace luna
+
+#endif // APPEVENTSTREAM_H
@@ -24,6 +24,7 @@
 #include <json-c/json.h>
 
 #include "applicationdescription.h"
+#include "logger.h"
 
 namespace luna
 {
@@ -53,7 +54,7 @@ void ApplicationDescription::initializeFromData(const QString &data)
 {
     struct json_object* root = json_tokener_parse( data.toUtf8().constData() );
     if (!root) {
-        qWarning() << "Failed to parse application description";
+        qCWarning(lcManager) << "Failed to parse application description";
         return;
     }
 
@@ -74,9 +75,9 @@ QUrl ApplicationDescription::locateEntryPoint(const QString &entryPoint) const
         return entryPointAsUrl;
 
     if (entryPointAsUrl.scheme() != "") {
-        qWarning("Entry point %s for application %s is invalid",
-                 entryPoint.toUtf8().constData(),
-                 getId().toUtf8().constData());
+        qCWarning(lcManager, "Entry point %s for application %s is invalid",
+                             entryPoint.toUtf8().constData(),
+                             getId().toUtf8().constData());
         return QUrl("");
     }
 
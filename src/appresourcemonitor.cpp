@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+#include <unistd.h>
+
+#include "appresourcemonitor.h"
+#include "jsonwriter.h"
+#include "webapplication.h"
+#include "webappmanager.h"
+#include "logger.h"
+
+#define APP_RESOURCE_USAGE_SUBSCRIPTION_KEY "appResourceUsage"
+#define SAMPLE_INTERVAL_MSEC                5000
+
+namespace luna
+{
+
+namespace
+{
+
+struct ProcessStat
+{
+    qint64 parent;
+    qint64 cpuTime;
+};
+
+bool readProcessStat(qint64 pid, ProcessStat &stat)
+{
+    QFile file(QString("/proc/%1/stat").arg(pid));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // the command name may contain spaces, the fields follow its closing parenthesis
+    QByteArray content = file.readAll();
+    QList<QByteArray> fields = content.mid(content.lastIndexOf(')') + 2).split(' ');
+    if (fields.size() < 13)
+        return false;
+
+    static const qint64 ticksPerSecond = sysconf(_SC_CLK_TCK);
+
+    stat.parent = fields.at(1).toLongLong();
+    stat.cpuTime = (fields.at(11).toLongLong() + fields.at(12).toLongLong()) * 1000 / ticksPerSecond;
+
+    return true;
+}
+
+bool isRendererProcess(qint64 pid)
+{
+    QFile file(QString("/proc/%1/cmdline").arg(pid));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    return file.readAll().split('\0').contains("--type=renderer");
+}
+
+// Renderers are forked by the zygote, so they are not our direct children
+QList<qint64> rendererProcesses()
+{
+    QHash<qint64, qint64> parents;
+
+    Q_FOREACH(const QString &entry, QDir("/proc").entryList(QDir::Dirs)) {
+        bool isPid = false;
+        qint64 pid = entry.toLongLong(&isPid);
+        ProcessStat stat;
+        if (isPid && readProcessStat(pid, stat))
+            parents.insert(pid, stat.parent);
+    }
+
+    QList<qint64> renderers;
+    qint64 self = getpid();
+
+    for (QHash<qint64, qint64>::const_iterator it = parents.constBegin(); it != parents.constEnd(); ++it) {
+        qint64 ancestor = it.value();
+        while (ancestor > 1 && ancestor != self)
+            ancestor = parents.value(ancestor, 0);
+
+        if (ancestor == self && isRendererProcess(it.key()))
+            renderers.append(it.key());
+    }
+
+    return renderers;
+}
+
+// Sums up the values of the given "name: value" fields of a /proc file
+void readProcFields(const QString &path, const char *first, qint64 &firstValue,
+                    const char *second = 0, qint64 *secondValue = 0)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    Q_FOREACH(const QByteArray &line, file.readAll().split('\n')) {
+        int separator = line.indexOf(':');
+        if (separator < 0)
+            continue;
+
+        QByteArray field = line.left(separator);
+        if (field == first)
+            firstValue += line.mid(separator + 1).trimmed().split(' ').first().toLongLong();
+        else if (second && field == second)
+            *secondValue += line.mid(separator + 1).trimmed().split(' ').first().toLongLong();
+    }
+}
+
+} // namespace
+
+AppResourceMonitor::ProcessUsage::ProcessUsage() :
+    cpuTime(0),
+    cpuUsage(0),
+    pss(0),
+    readBytes(0),
+    writeBytes(0)
+{
+}
+
+AppResourceMonitor::AppResourceMonitor(WebAppManager *webAppManager, QObject *parent) :
+    QObject(parent),
+    mWebAppManager(webAppManager),
+    mHandle(0)
+{
+    mSampleTimer.setInterval(SAMPLE_INTERVAL_MSEC);
+    connect(&mSampleTimer, SIGNAL(timeout()), this, SLOT(onSampleTimeout()));
+}
+
+void AppResourceMonitor::setServiceHandle(LS::Handle *handle)
+{
+    mHandle = handle;
+}
+
+void AppResourceMonitor::setRendererProcess(const QObject *view, const QString &appId, qint64 pid)
+{
+    // the renderer of the view is gone, a new one reports its pid again
+    if (pid <= 0) {
+        forgetView(view);
+        return;
+    }
+
+    qCDebug(lcManager) << "Renderer process" << pid << "renders a view of" << appId;
+
+    ViewRenderer renderer;
+    renderer.appId = appId;
+    renderer.pid = pid;
+    mViewRenderers.insert(view, renderer);
+}
+
+void AppResourceMonitor::forgetView(const QObject *view)
+{
+    mViewRenderers.remove(view);
+}
+
+void AppResourceMonitor::forgetApplication(const QString &appId)
+{
+    QHash<const QObject*, ViewRenderer>::iterator it = mViewRenderers.begin();
+    while (it != mViewRenderers.end()) {
+        if (it->appId == appId)
+            it = mViewRenderers.erase(it);
+        else
+            ++it;
+    }
+}
+
+int AppResourceMonitor::rendererProcessCount() const
+{
+    return rendererProcesses().size();
+}
+
+void AppResourceMonitor::sample()
+{
+    sample(mQueryClock);
+}
+
+void AppResourceMonitor::sample(SampleClock &clock)
+{
+    qint64 elapsed = clock.lastSample.isValid() ? clock.lastSample.restart() : 0;
+    if (!clock.lastSample.isValid())
+        clock.lastSample.start();
+
+    QHash<qint64, ProcessUsage> processes;
+    Q_FOREACH(const ViewRenderer &renderer, mViewRenderers) {
+        ProcessUsage &usage = processes[renderer.pid];
+        if (!usage.appIds.contains(renderer.appId))
+            usage.appIds.append(renderer.appId);
+    }
+
+    QHash<qint64, qint64> cpuTimes;
+    QHash<qint64, ProcessUsage>::iterator it = processes.begin();
+    while (it != processes.end()) {
+        ProcessStat stat;
+        if (!readProcessStat(it.key(), stat)) {
+            // the renderer exited or crashed meanwhile
+            it = processes.erase(it);
+            continue;
+        }
+
+        it->appIds.sort();
+        it->cpuTime = stat.cpuTime;
+        cpuTimes.insert(it.key(), stat.cpuTime);
+
+        QHash<qint64, qint64>::const_iterator previous = clock.cpuTimes.constFind(it.key());
+        if (elapsed > 0 && previous != clock.cpuTimes.constEnd() && stat.cpuTime > previous.value())
+            it->cpuUsage = 100.0 * (stat.cpuTime - previous.value()) / elapsed;
+
+        // smaps_rollup needs Linux 4.14, summing up smaps gives the same number
+        if (QFile::exists(QString("/proc/%1/smaps_rollup").arg(it.key())))
+            readProcFields(QString("/proc/%1/smaps_rollup").arg(it.key()), "Pss", it->pss);
+        else
+            readProcFields(QString("/proc/%1/smaps").arg(it.key()), "Pss", it->pss);
+
+        readProcFields(QString("/proc/%1/io").arg(it.key()), "read_bytes", it->readBytes,
+                       "write_bytes", &it->writeBytes);
+
+        ++it;
+    }
+
+    clock.cpuTimes = cpuTimes;
+    mProcesses = processes;
+}
+
+void AppResourceMonitor::writeUsage(JsonWriter &writer, const QString &appId) const
+{
+    ProcessUsage usage;
+    QList<qint64> processes;
+    QList<qint64> shared;
+
+    for (QHash<qint64, ProcessUsage>::const_iterator it = mProcesses.constBegin(); it != mProcesses.constEnd(); ++it) {
+        if (!it->appIds.contains(appId))
+            continue;
+
+        if (it->appIds.size() > 1) {
+            shared.append(it.key());
+            continue;
+        }
+
+        processes.append(it.key());
+        usage.cpuTime += it->cpuTime;
+        usage.cpuUsage += it->cpuUsage;
+        usage.pss += it->pss;
+        usage.readBytes += it->readBytes;
+        usage.writeBytes += it->writeBytes;
+    }
+
+    writer.beginObject();
+    writer.key("processes").beginArray();
+    Q_FOREACH(qint64 pid, processes)
+        writer.value(pid);
+    writer.endArray();
+    writer.member("cpuTime", usage.cpuTime);
+    writer.member("cpuUsage", usage.cpuUsage);
+    writer.member("pss", usage.pss);
+    writer.member("readBytes", usage.readBytes);
+    writer.member("writeBytes", usage.writeBytes);
+    writer.key("shared").beginArray();
+    Q_FOREACH(qint64 pid, shared) {
+        ProcessUsage process = mProcesses.value(pid);
+        writer.beginObject();
+        writer.member("processId", pid);
+        writer.key("appIds").beginArray();
+        Q_FOREACH(const QString &id, process.appIds)
+            writer.value(id);
+        writer.endArray();
+        writer.member("cpuTime", process.cpuTime);
+        writer.member("cpuUsage", process.cpuUsage);
+        writer.member("pss", process.pss);
+        writer.member("readBytes", process.readBytes);
+        writer.member("writeBytes", process.writeBytes);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+bool AppResourceMonitor::subscribe(LS::Message &request, const QString &appId)
+{
+    QByteArray key(APP_RESOURCE_USAGE_SUBSCRIPTION_KEY);
+    if (!appId.isEmpty())
+        key += "/" + appId.toUtf8();
+
+    LSError error;
+    LSErrorInit(&error);
+
+    if (!LSSubscriptionAdd(mHandle->get(), key.constData(), request.get(), &error)) {
+        LSErrorPrint(&error, stderr);
+        LSErrorFree(&error);
+        return false;
+    }
+
+    mSubscriptionKeys.insert(key);
+
+    if (!mSampleTimer.isActive())
+        mSampleTimer.start();
+
+    return true;
+}
+
+void AppResourceMonitor::onSampleTimeout()
+{
+    sample(mSubscriptionClock);
+
+    QSet<QByteArray>::iterator it = mSubscriptionKeys.begin();
+    while (it != mSubscriptionKeys.end()) {
+        QString appId;
+        int separator = it->indexOf('/');
+        if (separator >= 0)
+            appId = QString::fromUtf8(it->mid(separator + 1));
+
+        if (postUsage(*it, appId))
+            ++it;
+        else
+            it = mSubscriptionKeys.erase(it);
+    }
+
+    // nobody is listening anymore, don't keep reading /proc for nothing
+    if (mSubscriptionKeys.isEmpty()) {
+        mSampleTimer.stop();
+        mSubscriptionClock.lastSample.invalidate();
+        mSubscriptionClock.cpuTimes.clear();
+    }
+}
+
+bool AppResourceMonitor::postUsage(const QByteArray &key, const QString &appId)
+{
+    LSError error;
+    LSErrorInit(&error);
+
+    LSSubscriptionIter *iter = 0;
+    if (!LSSubscriptionAcquire(mHandle->get(), key.constData(), &iter, &error)) {
+        LSErrorPrint(&error, stderr);
+        LSErrorFree(&error);
+        return false;
+    }
+
+    bool subscribed = LSSubscriptionHasNext(iter);
+    if (subscribed) {
+        JsonWriter payload;
+        payload.beginObject();
+        payload.member("returnValue", true);
+        payload.key("apps").beginArray();
+        Q_FOREACH(WebApplication *app, mWebAppManager->applications()) {
+            if (!appId.isEmpty() && app->id() != appId)
+                continue;
+
+            payload.beginObject();
+            payload.member("appId", app->id());
+            payload.member("processId", (qint64) app->processId());
+            payload.key("resources");
+            writeUsage(payload, app->id());
+            payload.endObject();
+        }
+        payload.endArray();
+        payload.endObject();
+
+        while (LSSubscriptionHasNext(iter)) {
+            LSMessage *message = LSSubscriptionNext(iter);
+            if (!LSMessageReply(mHandle->get(), message, payload.constData(), &error)) {
+                LSErrorPrint(&error, stderr);
+                LSErrorFree(&error);
+            }
+        }
+    }
+
+    LSSubscriptionRelease(iter);
+
+    return subscribed;
+}
+
+} // namespace luna
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef APPRESOURCEMONITOR_H
+#define APPRESOURCEMONITOR_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <luna-service2/lunaservice.hpp>
+
+namespace luna
+{
+
+class JsonWriter;
+class WebAppManager;
+class WebApplication;
+
+/*
+ * Accounts CPU time, memory and I/O of the renderer processes to the
+ * applications they render.
+ *
+ * Every view reports the renderer process of its own page. A renderer used
+ * by views of several applications (hosted pages or --process-per-site) is
+ * reported as shared instead of being accounted to one of them. The
+ * processes are only sampled on request or while someone is subscribed to
+ * getAppResourceUsage; both keep their own clock so a one-off query doesn't
+ * skew the CPU usage the subscribers see.
+ */
+class AppResourceMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AppResourceMonitor(WebAppManager *webAppManager, QObject *parent = 0);
+
+    void setServiceHandle(LS::Handle *handle);
+
+    void setRendererProcess(const QObject *view, const QString &appId, qint64 pid);
+    void forgetView(const QObject *view);
+    void forgetApplication(const QString &appId);
+
+    void sample();
+    int rendererProcessCount() const;
+    void writeUsage(JsonWriter &writer, const QString &appId) const;
+
+    bool subscribe(LS::Message &request, const QString &appId);
+
+private Q_SLOTS:
+    void onSampleTimeout();
+
+private:
+    struct ViewRenderer
+    {
+        QString appId;
+        qint64 pid;
+    };
+
+    struct ProcessUsage
+    {
+        ProcessUsage();
+
+        QStringList appIds;
+        qint64 cpuTime;
+        double cpuUsage;
+        qint64 pss;
+        qint64 readBytes;
+        qint64 writeBytes;
+    };
+
+    struct SampleClock
+    {
+        QElapsedTimer lastSample;
+        QHash<qint64, qint64> cpuTimes;
+    };
+
+    WebAppManager *mWebAppManager;
+    LS::Handle *mHandle;
+    QHash<const QObject*, ViewRenderer> mViewRenderers;
+    QHash<qint64, ProcessUsage> mProcesses;
+    SampleClock mQueryClock;
+    SampleClock mSubscriptionClock;
+    QTimer mSampleTimer;
+    QSet<QByteArray> mSubscriptionKeys;
+
+    void sample(SampleClock &clock);
+    bool postUsage(const QByteArray &key, const QString &appId);
+};
+
+} // namespace luna
+
+#endif // APPRESOURCEMONITOR_H
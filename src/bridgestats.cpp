@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <string.h>
+
+#include "bridgestats.h"
+#include "jsonwriter.h"
+
+// apps hitting many different URIs, i.e. with parameters in them, fold the
+// rest into one entry instead of growing without bounds
+#define MAX_SERVICES_PER_APP 128
+#define OVERFLOW_SERVICE_URI "other"
+
+namespace luna
+{
+
+BridgeStats::Histogram::Histogram() :
+    mTotal(0),
+    mSum(0),
+    mMin(0),
+    mMax(0)
+{
+    memset(mCounts, 0, sizeof(mCounts));
+}
+
+int BridgeStats::Histogram::bucketForValue(qint64 value)
+{
+    if (value < 4)
+        return value < 0 ? 0 : value;
+
+    // the two bits below the most significant one pick the sub bucket
+    int msb = 63 - __builtin_clzll(value);
+    int bucket = (msb - 1) * 4 + ((value >> (msb - 2)) & 3);
+
+    return bucket < BucketCount ? bucket : BucketCount - 1;
+}
+
+qint64 BridgeStats::Histogram::bucketLowerBound(int bucket)
+{
+    if (bucket < 4)
+        return bucket;
+
+    return (qint64) (4 + bucket % 4) << (bucket / 4 - 1);
+}
+
+void BridgeStats::Histogram::record(qint64 value)
+{
+    mCounts[bucketForValue(value)]++;
+
+    if (mTotal == 0 || value < mMin)
+        mMin = value;
+    if (mTotal == 0 || value > mMax)
+        mMax = value;
+
+    mTotal++;
+    mSum += value;
+}
+
+qint64 BridgeStats::Histogram::valueAtPercentile(double percentile) const
+{
+    qint64 wanted = qMax((qint64) 1, (qint64) (mTotal * percentile / 100.0 + 0.5));
+    qint64 seen = 0;
+
+    for (int n = 0; n < BucketCount; n++) {
+        seen += mCounts[n];
+        if (seen >= wanted) {
+            // the highest value that falls into the bucket
+            qint64 upper = n + 1 < BucketCount ? bucketLowerBound(n + 1) - 1 : mMax;
+            return qBound(mMin, upper, mMax);
+        }
+    }
+
+    return mMax;
+}
+
+void BridgeStats::Histogram::write(JsonWriter &writer) const
+{
+    writer.beginObject();
+    writer.member("count", mTotal);
+
+    if (mTotal > 0) {
+        writer.member("min", mMin);
+        writer.member("max", mMax);
+        writer.member("mean", (double) mSum / mTotal);
+        writer.member("p50", valueAtPercentile(50));
+        writer.member("p90", valueAtPercentile(90));
+        writer.member("p99", valueAtPercentile(99));
+
+        // only the populated buckets, as [lowerBound, count] pairs
+        writer.key("buckets").beginArray();
+        for (int n = 0; n < BucketCount; n++) {
+            if (!mCounts[n])
+                continue;
+            writer.beginArray();
+            writer.value(bucketLowerBound(n));
+            writer.value((qint64) mCounts[n]);
+            writer.endArray();
+        }
+        writer.endArray();
+    }
+
+    writer.endObject();
+}
+
+BridgeStats::BridgeStats()
+{
+}
+
+BridgeStats::ServiceStats &BridgeStats::serviceStats(const QString &appId, const QString &uri)
+{
+    AppStats &app = mApps[appId];
+
+    AppStats::iterator it = app.find(uri);
+    if (it != app.end())
+        return *it;
+
+    if (app.size() >= MAX_SERVICES_PER_APP)
+        return app[OVERFLOW_SERVICE_URI];
+
+    return app[uri];
+}
+
+void BridgeStats::callStarted(const QString &appId, const QString &uri, int requestSize)
+{
+    ServiceStats &stats = serviceStats(appId, uri);
+    stats.calls++;
+    stats.requestSize.record(requestSize);
+}
+
+void BridgeStats::callFailed(const QString &appId, const QString &uri)
+{
+    serviceStats(appId, uri).failed++;
+}
+
+void BridgeStats::replyReceived(const QString &appId, const QString &uri, int replySize, qint64 firstReplyLatency)
+{
+    ServiceStats &stats = serviceStats(appId, uri);
+    stats.replySize.record(replySize);
+
+    if (firstReplyLatency >= 0)
+        stats.firstReplyLatency.record(firstReplyLatency);
+}
+
+void BridgeStats::callFinished(const QString &appId, const QString &uri, int replyCount, bool cancelled)
+{
+    ServiceStats &stats = serviceStats(appId, uri);
+    stats.replies.record(replyCount);
+
+    if (cancelled)
+        stats.cancelled++;
+}
+
+void BridgeStats::writeServiceStats(JsonWriter &writer, const QString &uri, const ServiceStats &stats)
+{
+    writer.beginObject();
+    writer.member("uri", uri);
+    writer.member("calls", stats.calls);
+    writer.member("failed", stats.failed);
+    writer.member("cancelled", stats.cancelled);
+    writer.key("firstReplyLatency");
+    stats.firstReplyLatency.write(writer);
+    writer.key("replies");
+    stats.replies.write(writer);
+    writer.key("requestSize");
+    stats.requestSize.write(writer);
+    writer.key("replySize");
+    stats.replySize.write(writer);
+    writer.endObject();
+}
+
+void BridgeStats::writeStats(JsonWriter &writer, const QString &appId, const QString &uri) const
+{
+    writer.beginArray();
+
+    for (QHash<QString, AppStats>::const_iterator app = mApps.constBegin(); app != mApps.constEnd(); ++app) {
+        if (!appId.isEmpty() && app.key() != appId)
+            continue;
+
+        writer.beginObject();
+        writer.member("appId", app.key());
+        writer.key("services").beginArray();
+        for (AppStats::const_iterator service = app->constBegin(); service != app->constEnd(); ++service) {
+            if (!uri.isEmpty() && service.key() != uri)
+                continue;
+            writeServiceStats(writer, service.key(), service.value());
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+
+    writer.endArray();
+}
+
+void BridgeStats::clear(const QString &appId)
+{
+    if (appId.isEmpty())
+        mApps.clear();
+    else
+        mApps.remove(appId);
+}
+
+} // namespace luna
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef BRIDGESTATS_H
+#define BRIDGESTATS_H
+
+#include <QHash>
+#include <QString>
+
+namespace luna
+{
+
+class JsonWriter;
+
+/*
+ * Aggregated statistics of the LS2 calls apps make through the bridge, per
+ * app and per service URI.
+ *
+ * Values go into log-linear histograms in the spirit of HdrHistogram: every
+ * power of two is split into four buckets, so a recorded value is known to
+ * within 25% whatever its magnitude while a histogram stays a fixed array.
+ */
+class BridgeStats
+{
+public:
+    BridgeStats();
+
+    void callStarted(const QString &appId, const QString &uri, int requestSize);
+    void callFailed(const QString &appId, const QString &uri);
+    void replyReceived(const QString &appId, const QString &uri, int replySize, qint64 firstReplyLatency);
+    void callFinished(const QString &appId, const QString &uri, int replyCount, bool cancelled);
+
+    // an empty appId or uri selects all of them
+    void writeStats(JsonWriter &writer, const QString &appId, const QString &uri) const;
+    void clear(const QString &appId);
+
+    class Histogram
+    {
+    public:
+        enum { BucketCount = 128 };
+
+        Histogram();
+
+        void record(qint64 value);
+        void write(JsonWriter &writer) const;
+
+        static int bucketForValue(qint64 value);
+        static qint64 bucketLowerBound(int bucket);
+
+    private:
+        qint64 valueAtPercentile(double percentile) const;
+
+        quint32 mCounts[BucketCount];
+        qint64 mTotal;
+        qint64 mSum;
+        qint64 mMin;
+        qint64 mMax;
+    };
+
+private:
+    struct ServiceStats
+    {
+        ServiceStats() : calls(0), failed(0), cancelled(0) {}
+
+        qint64 calls;
+        qint64 failed;
+        qint64 cancelled;
+        // microseconds from the call to its first reply
+        Histogram firstReplyLatency;
+        // replies per finished call, more than one for subscriptions
+        Histogram replies;
+        Histogram requestSize;
+        Histogram replySize;
+    };
+
+    typedef QHash<QString, ServiceStats> AppStats;
+
+    ServiceStats &serviceStats(const QString &appId, const QString &uri);
+    static void writeServiceStats(JsonWriter &writer, const QString &uri, const ServiceStats &stats);
+
+    QHash<QString, AppStats> mApps;
+};
+
+} // namespace luna
+
+#endif // BRIDGESTATS_H
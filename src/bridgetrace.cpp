@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <QJsonObject>
+
+#include "bridgetrace.h"
+#include "jsonwriter.h"
+
+#define MAX_RECORDS_PER_APP 512
+
+namespace luna
+{
+
+BridgeTrace::BridgeTrace(QObject *parent) :
+    QObject(parent)
+{
+}
+
+bool BridgeTrace::isEnabled(const QString &appId) const
+{
+    QHash<QString, AppTrace>::const_iterator it = mApps.constFind(appId);
+    return it != mApps.constEnd() && it->enabled;
+}
+
+void BridgeTrace::setEnabled(const QString &appId, bool enabled)
+{
+    if (isEnabled(appId) == enabled)
+        return;
+
+    // the records stay around after disabling until they are fetched
+    mApps[appId].enabled = enabled;
+
+    emit enabledChanged(appId, enabled);
+}
+
+void BridgeTrace::addRecords(const QString &appId, const QJsonArray &records)
+{
+    // a page may still deliver its last batch right after tracing stopped
+    if (!mApps.contains(appId))
+        return;
+
+    AppTrace &trace = mApps[appId];
+
+    Q_FOREACH(const QJsonValue &value, records) {
+        QJsonObject object = value.toObject();
+
+        Record record;
+        record.method = object.value("method").toString();
+        record.timestamp = (qint64) object.value("timestamp").toDouble();
+        record.latency = object.value("latency").toDouble();
+        record.requestSize = object.value("requestSize").toInt();
+        record.responseSize = object.value("responseSize").toInt();
+
+        if (trace.records.size() < MAX_RECORDS_PER_APP) {
+            trace.records.append(record);
+        }
+        else {
+            trace.records[trace.head] = record;
+            trace.head = (trace.head + 1) % MAX_RECORDS_PER_APP;
+            trace.dropped++;
+        }
+    }
+}
+
+void BridgeTrace::writeRecords(JsonWriter &writer, const QString &appId) const
+{
+    AppTrace trace = mApps.value(appId);
+
+    writer.beginObject();
+    writer.member("enabled", trace.enabled);
+    writer.member("dropped", trace.dropped);
+    writer.key("calls").beginArray();
+    for (int n = 0; n < trace.records.size(); n++) {
+        const Record &record = trace.records.at((trace.head + n) % trace.records.size());
+        writer.beginObject();
+        writer.member("method", record.method);
+        writer.member("timestamp", record.timestamp);
+        writer.member("latency", record.latency);
+        writer.member("requestSize", record.requestSize);
+        writer.member("responseSize", record.responseSize);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+void BridgeTrace::clear(const QString &appId)
+{
+    if (!mApps.contains(appId))
+        return;
+
+    if (mApps[appId].enabled) {
+        AppTrace &trace = mApps[appId];
+        trace.records.clear();
+        trace.head = 0;
+        trace.dropped = 0;
+    }
+    else {
+        mApps.remove(appId);
+    }
+}
+
+} // namespace luna
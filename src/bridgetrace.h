@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef BRIDGETRACE_H
+#define BRIDGETRACE_H
+
+#include <QHash>
+#include <QJsonArray>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+namespace luna
+{
+
+class JsonWriter;
+
+/*
+ * Bridge calls recorded by webos-api.js for the apps tracing was enabled for.
+ *
+ * The page only measures while its app is traced and hands the records over
+ * in batches, the last ones per app are kept here until somebody fetches
+ * them through the service.
+ */
+class BridgeTrace : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BridgeTrace(QObject *parent = 0);
+
+    bool isEnabled(const QString &appId) const;
+    void setEnabled(const QString &appId, bool enabled);
+
+    void addRecords(const QString &appId, const QJsonArray &records);
+    void writeRecords(JsonWriter &writer, const QString &appId) const;
+    void clear(const QString &appId);
+
+Q_SIGNALS:
+    void enabledChanged(const QString &appId, bool enabled);
+
+private:
+    struct Record
+    {
+        QString method;
+        qint64 timestamp;
+        double latency;
+        int requestSize;
+        int responseSize;
+    };
+
+    struct AppTrace
+    {
+        AppTrace() : enabled(false), head(0), dropped(0) {}
+
+        bool enabled;
+        QVector<Record> records;
+        // oldest record once the ring is full
+        int head;
+        qint64 dropped;
+    };
+
+    QHash<QString, AppTrace> mApps;
+};
+
+} // namespace luna
+
+#endif // BRIDGETRACE_H
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <limits.h>
+#include <unistd.h>
+
+#include <QFile>
+#include <QSettings>
+
+#include <Settings.h>
+
+#include "deviceprofile.h"
+#include "jsonwriter.h"
+#include "logger.h"
+
+#define DEVICE_PROFILE_CONFIG_FILE "/etc/luna-next/webappmanager.conf"
+
+namespace luna
+{
+
+namespace
+{
+
+struct TierDefaults
+{
+    const char *name;
+    int stageReadyTimeout;
+    int maxRendererRestarts;
+    int maxLiveCards;
+    int maxRenderers;
+    // in MiB
+    int httpCacheSize;
+    bool lowEndDeviceMode;
+    bool backgroundThrottling;
+};
+
+// indexed by DeviceProfile::Tier, closing cards the user didn't close is
+// up to the configuration only
+const TierDefaults tierDefaults[] = {
+    { "low",  5000, 2, 0, 4, 16, true,  true  },
+    { "mid",  3000, 3, 0, 8, 32, false, true  },
+    { "high", 3000, 3, 0, 0, 64, false, false },
+};
+
+qint64 readMemoryTotal()
+{
+    QFile file("/proc/meminfo");
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+
+    Q_FOREACH(const QByteArray &line, file.readAll().split('\n')) {
+        // MemTotal:        1882372 kB
+        if (line.startsWith("MemTotal:"))
+            return line.mid(9).trimmed().split(' ').first().toLongLong();
+    }
+
+    return 0;
+}
+
+int readMaxFrequency(int cores)
+{
+    int maxFrequency = 0;
+
+    // big.LITTLE parts report different maxima per core
+    for (int n = 0; n < cores; n++) {
+        QFile file(QString("/sys/devices/system/cpu/cpu%1/cpufreq/cpuinfo_max_freq").arg(n));
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+
+        int frequency = file.readAll().trimmed().toInt() / 1000;
+        if (frequency > maxFrequency)
+            maxFrequency = frequency;
+    }
+
+    return maxFrequency;
+}
+
+} // namespace
+
+DeviceProfile::DeviceProfile() :
+    mTier(TierMid),
+    mMemoryTotal(0),
+    mCores(0),
+    mMaxFrequency(0),
+    mDesktop(false)
+{
+    applyTier(mTier);
+}
+
+DeviceProfile DeviceProfile::detect()
+{
+    DeviceProfile profile;
+
+    profile.classify();
+
+    QSettings settings(DEVICE_PROFILE_CONFIG_FILE, QSettings::IniFormat);
+    profile.applyOverrides(settings);
+
+    qCInfo(lcManager) << "Device profile" << tierDefaults[profile.mTier].name
+                      << "for" << profile.mMemoryTotal / 1024 << "MiB," << profile.mCores << "cores at"
+                      << profile.mMaxFrequency << "MHz, overrides" << profile.mOverrides;
+
+    return profile;
+}
+
+void DeviceProfile::classify()
+{
+    mMemoryTotal = readMemoryTotal();
+    mCores = qMax(sysconf(_SC_NPROCESSORS_CONF), 0L);
+    mMaxFrequency = readMaxFrequency(mCores);
+    mDesktop = Settings::LunaSettings()->hardwareType == Settings::HardwareTypeDesktop;
+
+    Tier tier = TierHigh;
+
+    // don't take a device we know nothing about for a weak one
+    if (!mDesktop && (mMemoryTotal == 0 || mCores == 0)) {
+        qCWarning(lcManager) << "Failed to read the memory size or core count, using the default tier";
+        tier = TierMid;
+    }
+    else if (!mDesktop) {
+        if (mMemoryTotal < 1536 * 1024 || mCores <= 2)
+            tier = TierLow;
+        else if (mMemoryTotal < 3 * 1024 * 1024 || mCores <= 4)
+            tier = TierMid;
+
+        // plenty of slow cores don't make up for the speed, unknown counts as fast
+        if (mMaxFrequency > 0 && mMaxFrequency < 1200 && tier > TierLow)
+            tier = (Tier) (tier - 1);
+    }
+
+    applyTier(tier);
+}
+
+void DeviceProfile::applyTier(Tier tier)
+{
+    const TierDefaults &defaults = tierDefaults[tier];
+
+    mTier = tier;
+    mStageReadyTimeout = defaults.stageReadyTimeout;
+    mMaxRendererRestarts = defaults.maxRendererRestarts;
+    mMaxLiveCards = defaults.maxLiveCards;
+    mMaxRenderers = defaults.maxRenderers;
+    mHttpCacheSize = defaults.httpCacheSize * 1024 * 1024;
+    mLowEndDeviceMode = defaults.lowEndDeviceMode;
+    mBackgroundThrottling = defaults.backgroundThrottling;
+}
+
+void DeviceProfile::applyOverrides(QSettings &settings)
+{
+    settings.beginGroup("DeviceProfile");
+
+    // the tier goes first, the single values are on top of it
+    if (settings.contains("tier")) {
+        QString name = settings.value("tier").toString();
+        bool found = false;
+        for (int n = TierLow; n <= TierHigh; n++) {
+            if (name == tierDefaults[n].name) {
+                applyTier((Tier) n);
+                found = true;
+            }
+        }
+
+        if (found)
+            mOverrides << "tier";
+        else
+            qCWarning(lcManager) << "Ignoring unknown device tier" << name;
+    }
+
+    struct { const char *key; int *value; int scale; } intValues[] = {
+        { "stageReadyTimeout", &mStageReadyTimeout, 1 },
+        { "maxRendererRestarts", &mMaxRendererRestarts, 1 },
+        { "maxLiveCards", &mMaxLiveCards, 1 },
+        { "maxRenderers", &mMaxRenderers, 1 },
+        { "httpCacheSize", &mHttpCacheSize, 1024 * 1024 },
+    };
+
+    for (unsigned int n = 0; n < sizeof(intValues) / sizeof(intValues[0]); n++) {
+        if (!settings.contains(intValues[n].key))
+            continue;
+
+        bool ok = false;
+        int value = settings.value(intValues[n].key).toInt(&ok);
+        // the web engine takes the cache size as int bytes, 2047 MiB at most
+        if (!ok || value < 0 || value > INT_MAX / intValues[n].scale) {
+            qCWarning(lcManager) << "Ignoring invalid device profile value" << intValues[n].key;
+            continue;
+        }
+
+        *intValues[n].value = value * intValues[n].scale;
+        mOverrides << intValues[n].key;
+    }
+
+    struct { const char *key; bool *value; } boolValues[] = {
+        { "lowEndDeviceMode", &mLowEndDeviceMode },
+        { "backgroundThrottling", &mBackgroundThrottling },
+    };
+
+    for (unsigned int n = 0; n < sizeof(boolValues) / sizeof(boolValues[0]); n++) {
+        if (!settings.contains(boolValues[n].key))
+            continue;
+
+        *boolValues[n].value = settings.value(boolValues[n].key).toBool();
+        mOverrides << boolValues[n].key;
+    }
+
+    settings.endGroup();
+}
+
+QStringList DeviceProfile::chromiumFlags() const
+{
+    QStringList flags;
+
+    if (mLowEndDeviceMode)
+        flags << "--enable-low-end-device-mode";
+
+    if (!mBackgroundThrottling)
+        flags << "--disable-background-timer-throttling" << "--disable-renderer-backgrounding";
+
+    return flags;
+}
+
+void DeviceProfile::write(JsonWriter &writer) const
+{
+    writer.beginObject();
+    writer.member("tier", tierDefaults[mTier].name);
+
+    writer.key("device").beginObject();
+    writer.member("memoryTotal", mMemoryTotal * 1024);
+    writer.member("cores", mCores);
+    writer.member("maxFrequency", mMaxFrequency);
+    writer.member("desktop", mDesktop);
+    writer.endObject();
+
+    writer.member("stageReadyTimeout", mStageReadyTimeout);
+    writer.member("maxRendererRestarts", mMaxRendererRestarts);
+    writer.member("maxLiveCards", mMaxLiveCards);
+    writer.member("maxRenderers", mMaxRenderers);
+    writer.member("httpCacheSize", mHttpCacheSize);
+    writer.member("lowEndDeviceMode", mLowEndDeviceMode);
+    writer.member("backgroundThrottling", mBackgroundThrottling);
+
+    writer.key("overrides").beginArray();
+    Q_FOREACH(const QString &key, mOverrides)
+        writer.value(key);
+    writer.endArray();
+
+    writer.endObject();
+}
+
+} // namespace luna
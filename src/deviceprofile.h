@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef DEVICEPROFILE_H
+#define DEVICEPROFILE_H
+
+#include <QStringList>
+
+class QSettings;
+
+namespace luna
+{
+
+class JsonWriter;
+
+/*
+ * Tuning of the manager for the device it runs on.
+ *
+ * At startup the device is put into a tier by its memory, cores, CPU
+ * frequency and hardware type and the tier picks a consistent set of
+ * limits. Every value, the tier included, can be overridden in the
+ * [DeviceProfile] group of /etc/luna-next/webappmanager.conf.
+ */
+class DeviceProfile
+{
+public:
+    enum Tier
+    {
+        TierLow = 0,
+        TierMid,
+        TierHigh,
+    };
+
+    DeviceProfile();
+
+    static DeviceProfile detect();
+
+    Tier tier() const { return mTier; }
+
+    // milliseconds a hidden card may take to become ready before it is shown anyway
+    int stageReadyTimeout() const { return mStageReadyTimeout; }
+    int maxRendererRestarts() const { return mMaxRendererRestarts; }
+    // 0 for no limit, same for the renderers
+    int maxLiveCards() const { return mMaxLiveCards; }
+    int maxRenderers() const { return mMaxRenderers; }
+    // in bytes
+    int httpCacheSize() const { return mHttpCacheSize; }
+    bool lowEndDeviceMode() const { return mLowEndDeviceMode; }
+    bool backgroundThrottling() const { return mBackgroundThrottling; }
+
+    QStringList chromiumFlags() const;
+
+    void write(JsonWriter &writer) const;
+
+private:
+    Tier mTier;
+
+    qint64 mMemoryTotal;
+    int mCores;
+    int mMaxFrequency;
+    bool mDesktop;
+
+    int mStageReadyTimeout;
+    int mMaxRendererRestarts;
+    int mMaxLiveCards;
+    int mMaxRenderers;
+    int mHttpCacheSize;
+    bool mLowEndDeviceMode;
+    bool mBackgroundThrottling;
+
+    QStringList mOverrides;
+
+    void classify();
+    void applyTier(Tier tier);
+    void applyOverrides(QSettings &settings);
+};
+
+} // namespace luna
+
+#endif // DEVICEPROFILE_H
@@ -8,6 +8,7 @@ navigator.BluetoothManager.ondisabled = null;
 
 navigator.BluetoothManager.ondevicefound = null;
 navigator.BluetoothManager.ondevicechanged = null;
+navigator.BluetoothManager.ondeviceschanged = null;
 navigator.BluetoothManager.ondeviceremoved = null;
 navigator.BluetoothManager.ondevicedisappeared = null;
 navigator.BluetoothManager.onpropertychanged = null;
@@ -44,6 +45,18 @@ __BluetoothManager.deviceChanged = function(deviceInfo) {
       navigator.BluetoothManager.ondevicechanged(deviceInfo);
 }
 
+__BluetoothManager.devicesChanged = function(events) {
+    if (typeof navigator.BluetoothManager.ondeviceschanged === 'function')
+      navigator.BluetoothManager.ondeviceschanged(events);
+
+    for (var n = 0; n < events.length; n++) {
+        if (events[n].event === "found")
+            __BluetoothManager.deviceFound(events[n].device);
+        else
+            __BluetoothManager.deviceChanged(events[n].device);
+    }
+}
+
 __BluetoothManager.deviceRemoved = function(address) {
     if (typeof navigator.BluetoothManager.ondeviceremoved === 'function')
       navigator.BluetoothManager.ondeviceremoved(address);
@@ -119,3 +132,5 @@ navigator.BluetoothManager.confirmPasskey = function(tag, confirmed) {
 navigator.BluetoothManager.displayPasskeyCallback = function(tag) {
     _webOS.execWithoutCallback("BluetoothManager", "displayPasskeyCallback", [tag]);
 }
+
+_webOS.subscribeEvents("BluetoothManager", __BluetoothManager);
@@ -58,3 +58,7 @@ __InAppBrowser.userClickedDone = function(frameName) {
     if (typeof navObj.InAppBrowser.ondoneclicked === 'function')
       navObj.InAppBrowser.ondoneclicked();
 }
+
+// events are delivered to the top frame which looks up the target frame
+if (window.top === window)
+    _webOS.subscribeEvents("InAppBrowser", __InAppBrowser);
@@ -1,5 +1,6 @@
 __WiFiManager = {};
 __WiFiManager.powered = false;
+__WiFiManager.networks = [];
 
 navigator.WiFiManager = {};
 
@@ -7,6 +8,7 @@ navigator.WiFiManager.onenabled = null;
 navigator.WiFiManager.ondisabled = null;
 navigator.WiFiManager.onstatuschange = null;
 navigator.WiFiManager.onnetworkschange = null;
+navigator.WiFiManager.onnetworksdiff = null;
 navigator.WiFiManager.connectionInfoUpdate = null;
 
 __WiFiManager.setPowered = function(powered) {
@@ -21,10 +23,37 @@ __WiFiManager.setPowered = function(powered) {
 }
 
 __WiFiManager.networksChanged = function(networks) {
+    __WiFiManager.networks = networks;
+
     if (typeof navigator.WiFiManager.onnetworkschange === 'function')
       navigator.WiFiManager.onnetworkschange(networks);
 }
 
+__WiFiManager.networksUpdated = function(diff) {
+    var networksByPath = {};
+    var n;
+
+    for (n = 0; n < __WiFiManager.networks.length; n++)
+        networksByPath[__WiFiManager.networks[n].path] = __WiFiManager.networks[n];
+    for (n = 0; n < diff.changed.length; n++)
+        networksByPath[diff.changed[n].path] = diff.changed[n];
+    for (n = 0; n < diff.added.length; n++)
+        networksByPath[diff.added[n].path] = diff.added[n];
+
+    // keep the order connman sorts the networks in, removed ones aren't in it
+    __WiFiManager.networks = diff.order.filter(function(path) {
+        return networksByPath.hasOwnProperty(path);
+    }).map(function(path) {
+        return networksByPath[path];
+    });
+
+    if (typeof navigator.WiFiManager.onnetworksdiff === 'function')
+      navigator.WiFiManager.onnetworksdiff(diff);
+
+    if (typeof navigator.WiFiManager.onnetworkschange === 'function')
+      navigator.WiFiManager.onnetworkschange(__WiFiManager.networks);
+}
+
 Object.defineProperty(navigator.WiFiManager, "enabled", {
   get: function() { return __WiFiManager.enabled; },
   set: function(value) { __WiFiManager.setPowered(value); }
@@ -34,6 +63,10 @@ navigator.WiFiManager.retrieveNetworks = function(succesCallback, errorCallback)
     _webOS.exec(succesCallback, errorCallback, "WiFiManager", "retrieveNetworks");
 }
 
+navigator.WiFiManager.getNetworks = function(succesCallback, errorCallback) {
+    _webOS.exec(succesCallback, errorCallback, "WiFiManager", "getNetworks");
+}
+
 navigator.WiFiManager.connectNetwork = function(network, succesCallback, errorCallback) {
     _webOS.exec(succesCallback, errorCallback, "WiFiManager", "connectNetwork", [JSON.stringify(network)]);
 }
@@ -49,3 +82,5 @@ navigator.WiFiManager.disconnectNetwork = function(path) {
 navigator.WiFiManager.removeNetwork = function(path) {
     _webOS.execWithoutCallback("WiFiManager", "removeNetwork", [path]);
 }
+
+_webOS.subscribeEvents("WiFiManager", __WiFiManager);
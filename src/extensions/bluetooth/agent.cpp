@@ -19,6 +19,7 @@
  */
 
 #include "agent.h"
+#include "../../logger.h"
 
 #include <cassert>
 
@@ -255,7 +256,7 @@ void Agent::DisplayPasskey(const QDBusObjectPath &objectPath, uint passkey, usho
  */
 void Agent::Cancel()
 {
-    qWarning() << "Cancel callback called";
+    qCWarning(luna::lcExtension) << "Cancel callback called";
 }
 
 /**
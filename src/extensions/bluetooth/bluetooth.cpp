@@ -25,6 +25,7 @@
 #include "agent.h"
 #include "agentadaptor.h"
 #include "dbus-shared.h"
+#include "../../logger.h"
 
 Bluetooth::Bluetooth(QObject *parent):
     Bluetooth(QDBusConnection::systemBus(), parent)
@@ -40,7 +41,7 @@ Bluetooth::Bluetooth(const QDBusConnection &dbus, QObject *parent):
     // export our Agent to handle pairing requests
     new bluetooth::AgentAdaptor(&m_agent);
     if(!m_dbus.registerObject(DBUS_ADAPTER_AGENT_PATH, &m_agent))
-        qCritical() << "Couldn't register agent at" << DBUS_ADAPTER_AGENT_PATH;
+        qCCritical(luna::lcExtension) << "Couldn't register agent at" << DBUS_ADAPTER_AGENT_PATH;
 
     m_connectedDevices.filterOnConnections(Device::Connection::Connected |
                                            Device::Connection::Connecting |
@@ -183,11 +184,11 @@ void Bluetooth::disconnectDevice()
             m_selectedDevice->disconnect(Device::ConnectionMode::Input);
             break;
         default:
-            qWarning() << "Nothing to disconnect: Unsupported device type.";
+            qCWarning(luna::lcExtension) << "Nothing to disconnect: Unsupported device type.";
             break;
         }
     } else {
-        qWarning() << "No selected device to disconnect";
+        qCWarning(luna::lcExtension) << "No selected device to disconnect";
     }
 }
 
@@ -198,7 +199,7 @@ void Bluetooth::connectDevice(const QString &address)
     Device::Type type;
 
     if (!device) {
-        qWarning() << "No device to connect.";
+        qCWarning(luna::lcExtension) << "No device to connect.";
         return;
     }
 
@@ -216,8 +217,8 @@ void Bluetooth::connectDevice(const QString &address)
         connMode = Device::ConnectionMode::Input;
         break;
     default:
-        qWarning() << "Nothing to connect: Unsupported device type.";
-        qWarning() << "Nothing to connect: trying to pair...";
+        qCWarning(luna::lcExtension) << "Nothing to connect: Unsupported device type.";
+        qCWarning(luna::lcExtension) << "Nothing to connect: trying to pair...";
         m_devices.createDevice(address, &m_agent);
         return;
     }
@@ -236,7 +237,7 @@ void Bluetooth::removeDevice()
         QString path = m_selectedDevice->getPath();
         m_devices.removeDevice(path);
     } else {
-        qWarning() << "No selected device to remove.";
+        qCWarning(luna::lcExtension) << "No selected device to remove.";
     }
 }
 
@@ -25,6 +25,7 @@
 #include <QTimer>
 
 #include "dbus-shared.h"
+#include "../../logger.h"
 
 /***
 ****
@@ -89,7 +90,7 @@ void Device::initInterface(QSharedPointer<QDBusInterface> &setme,
     } else {
         if (!bus.connect(service, path, interfaceName, "PropertyChanged",
                          this, SLOT(slotPropertyChanged(const QString&, const QDBusVariant&))))
-            qWarning() << "Unable to connect to " << interfaceName << "::PropertyChanged on" << path;
+            qCWarning(luna::lcExtension) << "Unable to connect to " << interfaceName << "::PropertyChanged on" << path;
     }
 
     setme.reset(i);
@@ -140,7 +141,7 @@ void Device::slotServiceDiscoveryDone(QDBusPendingCallWatcher *call)
             connect(mode);
         }
     } else {
-        qWarning() << "Could not initiate service discovery:"
+        qCWarning(luna::lcExtension) << "Could not initiate service discovery:"
                    << reply.error().message();
     }
     call->deleteLater();
@@ -159,7 +160,7 @@ void Device::discoverServices()
                          this,
                          SLOT(slotServiceDiscoveryDone(QDBusPendingCallWatcher*)));
     } else {
-        qWarning() << "Can't do service discovery: the device interface is not ready.";
+        qCWarning(luna::lcExtension) << "Can't do service discovery: the device interface is not ready.";
     }
 }
 
@@ -168,7 +169,7 @@ void Device::slotDisconnectDone(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<void> reply = *watcher;
 
     if (reply.isError()) {
-        qWarning() << "Could not disconnect device:"
+        qCWarning(luna::lcExtension) << "Could not disconnect device:"
                    << reply.error().message();
     }
 
@@ -186,7 +187,7 @@ void Device::disconnect(ConnectionMode mode)
     else if (m_inputInterface && (mode == Input))
         interface = m_inputInterface;
     else {
-        qWarning() << "Unhandled connection mode" << mode;
+        qCWarning(luna::lcExtension) << "Unhandled connection mode" << mode;
         return;
     }
 
@@ -201,7 +202,7 @@ void Device::slotConnectDone(QDBusPendingCallWatcher *watcher)
     QDBusPendingReply<void> reply = *watcher;
 
     if (reply.isError()) {
-        qWarning() << "Could not connect device:"
+        qCWarning(luna::lcExtension) << "Could not connect device:"
                    << reply.error().message();
     }
 
@@ -219,7 +220,7 @@ void Device::connect(ConnectionMode mode)
     else if (m_inputInterface && (mode == Input))
         interface = m_inputInterface;
     else {
-        qWarning() << "Unhandled connection mode" << mode;
+        qCWarning(luna::lcExtension) << "Unhandled connection mode" << mode;
         return;
     }
 
@@ -234,7 +235,7 @@ void Device::slotMakeTrustedDone(QDBusPendingCallWatcher *call)
     QDBusPendingReply<void> reply = *call;
 
     if (reply.isError()) {
-        qWarning() << "Could not set device as trusted:"
+        qCWarning(luna::lcExtension) << "Could not set device as trusted:"
                    << reply.error().message();
     }
     call->deleteLater();
@@ -258,7 +259,7 @@ void Device::makeTrusted(bool trusted)
                          this,
                          SLOT(slotServiceDiscoveryDone(QDBusPendingCallWatcher*)));
     } else {
-        qWarning() << "Can't set device trusted before it is added in BlueZ";
+        qCWarning(luna::lcExtension) << "Can't set device trusted before it is added in BlueZ";
     }
 }
 
@@ -24,6 +24,7 @@
 #include <QDebug>
 
 #include "dbus-shared.h"
+#include "../../logger.h"
 
 namespace
 {
@@ -32,6 +33,101 @@ namespace
   const int SCANNING_IDLE_DURATION_MSEC = (10 * 1000);
 }
 
+/***
+****  Store
+***/
+
+int DeviceStore::rowOfPath(const QString &path) const
+{
+    const Device *device = m_deviceByPath.value(path, nullptr);
+
+    return device != nullptr ? rowOfDevice(device) : -1;
+}
+
+int DeviceStore::append(const QSharedPointer<Device> &device)
+{
+    const int row = m_devices.size();
+
+    m_devices.append(device);
+    index(row);
+
+    return row;
+}
+
+void DeviceStore::replace(int row, const QSharedPointer<Device> &device)
+{
+    if (m_devices[row] != device) {
+        unindex(m_devices[row].data());
+        m_devices[row] = device;
+    }
+
+    index(row);
+}
+
+void DeviceStore::removeAt(int row)
+{
+    unindex(m_devices[row].data());
+    m_devices.removeAt(row);
+
+    // only the rows behind the removed one have moved
+    for (int i=row, n=m_devices.size(); i<n; i++) {
+        const Device *device = m_devices[i].data();
+        m_rowByDevice[device] = i;
+        m_rowByAddress[m_keys[device].address] = i;
+    }
+}
+
+void DeviceStore::refresh(int row)
+{
+    index(row);
+}
+
+void DeviceStore::clear()
+{
+    m_devices.clear();
+    m_rowByAddress.clear();
+    m_deviceByPath.clear();
+    m_rowByDevice.clear();
+    m_keys.clear();
+}
+
+void DeviceStore::index(int row)
+{
+    const Device *device = m_devices[row].data();
+    Keys &keys = m_keys[device];
+
+    // address and path may change once bluez hands out the device object
+    const QString &address = device->getAddress();
+    if (keys.address != address) {
+        if (m_rowByAddress.value(keys.address, -1) == row)
+            m_rowByAddress.remove(keys.address);
+        keys.address = address;
+    }
+
+    const QString path = device->getPath();
+    if (keys.path != path) {
+        if (m_deviceByPath.value(keys.path, nullptr) == device)
+            m_deviceByPath.remove(keys.path);
+        keys.path = path;
+    }
+
+    m_rowByDevice[device] = row;
+    m_rowByAddress[keys.address] = row;
+    if (!keys.path.isEmpty())
+        m_deviceByPath[keys.path] = device;
+}
+
+void DeviceStore::unindex(const Device *device)
+{
+    const Keys keys = m_keys.take(device);
+    const int row = m_rowByDevice.take(device);
+
+    if (m_rowByAddress.value(keys.address, -1) == row)
+        m_rowByAddress.remove(keys.address);
+    if (m_deviceByPath.value(keys.path, nullptr) == device)
+        m_deviceByPath.remove(keys.path);
+}
+
 /***
 ****
 ***/
@@ -70,11 +166,7 @@ DeviceModel::~DeviceModel()
 
 int DeviceModel::findRowFromAddress(const QString &address) const
 {
-    for (int i=0, n=m_devices.size(); i<n; i++)
-        if (m_devices[i]->getAddress() == address)
-            return i;
-
-    return -1;
+    return m_devices.rowOfAddress(address);
 }
 
 /***
@@ -199,7 +291,7 @@ void DeviceModel::setAdapterFromPath(const QString &path)
                                                        qVariantFromValue(QDBusObjectPath(DBUS_ADAPTER_AGENT_PATH)),
                                                        QString(DBUS_AGENT_CAPABILITY));
         if (!reply.isValid())
-                qWarning() << "Error registering agent for the default adapter:" << reply.error();
+                qCWarning(luna::lcExtension) << "Error registering agent for the default adapter:" << reply.error();
     }
 }
 
@@ -284,7 +376,7 @@ void DeviceModel::trySetDiscoverable(bool discoverable)
     if (m_bluezAdapter && m_bluezAdapter->isValid() && m_isPowered) {
         reply = m_bluezAdapter->call("SetProperty", "Discoverable", value);
         if (!reply.isValid())
-            qWarning() << "Error setting device discoverable:" << reply.error();
+            qCWarning(luna::lcExtension) << "Error setting device discoverable:" << reply.error();
     }
 }
 
@@ -313,7 +405,7 @@ void DeviceModel::addDevice(QSharedPointer<Device> &device)
     int row = findRowFromAddress(device->getAddress());
 
     if (row >= 0) { // update existing device
-        m_devices[row] = device;
+        m_devices.replace(row, device);
         emitRowChanged(row);
     } else { // add new device
         row = m_devices.size();
@@ -326,14 +418,14 @@ void DeviceModel::addDevice(QSharedPointer<Device> &device)
 
 void DeviceModel::resetDevicesList()
 {
-    for (auto device : m_devices)
+    for (auto device : m_devices.devices())
         emit deviceFound(device);
 }
 
 void DeviceModel::removeRow(int row)
 {
     if (0<=row && row<m_devices.size()) {
-        emit deviceRemoved(m_devices[row]->getAddress());
+        emit deviceRemoved(m_devices.at(row)->getAddress());
         beginRemoveRows(QModelIndex(), row, row);
         m_devices.removeAt(row);
         endRemoveRows();
@@ -382,7 +474,7 @@ void DeviceModel::slotDeviceCreated(const QDBusObjectPath &path)
             }
         }
     } else {
-        qWarning() << "Invalid device properties for" << path.path();
+        qCWarning(luna::lcExtension) << "Invalid device properties for" << path.path();
     }
 }
 
@@ -421,7 +513,7 @@ void DeviceModel::slotDeviceDisappeared(const QString &address)
 {
     const int row = findRowFromAddress(address);
     emit deviceDisappeared(address);
-    if ((row >= 0) && !m_devices[row]->isPaired())
+    if ((row >= 0) && !m_devices.at(row)->isPaired())
         removeRow(row);
 }
 
@@ -430,15 +522,13 @@ void DeviceModel::slotDeviceChanged()
     const Device * device = qobject_cast<Device*>(sender());
 
     // find the row that goes with this device
-    int row = -1;
-    if (device != nullptr)
-        for (int i=0, n=m_devices.size(); row==-1 && i<n; i++)
-            if (m_devices[i].data() == device)
-                row = i;
+    const int row = device != nullptr ? m_devices.rowOfDevice(device) : -1;
 
     if (row != -1) {
+        m_devices.refresh(row);
         emitRowChanged(row);
-        emit deviceChanged(m_devices[row]);
+        QSharedPointer<Device> changed = m_devices.at(row);
+        emit deviceChanged(changed);
     }
 }
 
@@ -448,16 +538,16 @@ QSharedPointer<Device> DeviceModel::getDeviceFromAddress(const QString &address)
 
     const int row = findRowFromAddress(address);
     if (row >= 0)
-        device = m_devices[row];
+        device = m_devices.at(row);
 
     return device;
 }
 
 QSharedPointer<Device> DeviceModel::getDeviceFromPath(const QString &path)
 {
-    for (auto device : m_devices)
-        if (device->getPath() == path)
-            return device;
+    const int row = m_devices.rowOfPath(path);
+    if (row >= 0)
+        return m_devices.at(row);
 
     return QSharedPointer<Device>();
 }
@@ -468,7 +558,7 @@ void DeviceModel::addConnectAfterPairing(const QString &address, Device::Connect
     if (device) {
         device->addConnectAfterPairing(mode);
     } else {
-        qWarning() << "Device could not be found, can't add an operation";
+        qCWarning(luna::lcExtension) << "Device could not be found, can't add an operation";
     }
 }
 
@@ -477,7 +567,7 @@ void DeviceModel::slotCreateFinished(QDBusPendingCallWatcher *call)
     QDBusPendingReply<QDBusObjectPath> reply = *call;
 
     if (reply.isError()) {
-        qWarning() << "Could not create device:" << reply.error().message();
+        qCWarning(luna::lcExtension) << "Could not create device:" << reply.error().message();
     }
 
     call->deleteLater();
@@ -492,7 +582,7 @@ void DeviceModel::createDevice (const QString &address, QObject *agent)
         agent_path.replace(":", "_");
 
         if(!m_dbus.registerObject(agent_path, agent))
-            qCritical() << "Couldn't register agent at" << agent_path;
+            qCCritical(luna::lcExtension) << "Couldn't register agent at" << agent_path;
 
         QDBusPendingCall pcall = m_bluezAdapter->asyncCall("CreatePairedDevice",
                                                            address,
@@ -503,7 +593,7 @@ void DeviceModel::createDevice (const QString &address, QObject *agent)
         QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
                          this, SLOT(slotCreateFinished(QDBusPendingCallWatcher*)));
     } else {
-        qWarning() << "Default adapter is not available for device creation";
+        qCWarning(luna::lcExtension) << "Default adapter is not available for device creation";
     }
 }
 
@@ -512,7 +602,7 @@ void DeviceModel::slotRemoveFinished(QDBusPendingCallWatcher *call)
     QDBusPendingReply<void> reply = *call;
 
     if (reply.isError()) {
-        qWarning() << "Could not remove device:" << reply.error().message();
+        qCWarning(luna::lcExtension) << "Could not remove device:" << reply.error().message();
     }
     call->deleteLater();
 }
@@ -526,7 +616,7 @@ void DeviceModel::removeDevice (const QString &path)
         QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
                          this, SLOT(slotRemoveFinished(QDBusPendingCallWatcher*)));
     } else {
-        qWarning() << "Default adapter is not available for device removal";
+        qCWarning(luna::lcExtension) << "Default adapter is not available for device removal";
     }
 }
 
@@ -565,7 +655,7 @@ QVariant DeviceModel::data(const QModelIndex &index, int role) const
 
     if ((0<=index.row()) && (index.row()<m_devices.size())) {
 
-        auto device = m_devices[index.row()];
+        auto device = m_devices.at(index.row());
         QString displayName;
 
         switch (role) {
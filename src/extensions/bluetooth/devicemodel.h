@@ -35,6 +35,46 @@
 
 #include "device.h"
 
+/*
+ * Row storage for DeviceModel. Keeps the devices in row order and maintains
+ * hash indices on address, object path and Device instance so lookups done
+ * for every discovery result don't have to scan the whole list.
+ */
+class DeviceStore
+{
+public:
+    int size() const { return m_devices.size(); }
+    bool isEmpty() const { return m_devices.isEmpty(); }
+    const QSharedPointer<Device> &at(int row) const { return m_devices.at(row); }
+    const QList<QSharedPointer<Device> > &devices() const { return m_devices; }
+
+    int rowOfAddress(const QString &address) const { return m_rowByAddress.value(address, -1); }
+    int rowOfPath(const QString &path) const;
+    int rowOfDevice(const Device *device) const { return m_rowByDevice.value(device, -1); }
+
+    int append(const QSharedPointer<Device> &device);
+    void replace(int row, const QSharedPointer<Device> &device);
+    void removeAt(int row);
+    void refresh(int row);
+    void clear();
+
+private:
+    struct Keys
+    {
+        QString address;
+        QString path;
+    };
+
+    QList<QSharedPointer<Device> > m_devices;
+    QHash<QString,int> m_rowByAddress;
+    QHash<QString,const Device*> m_deviceByPath;
+    QHash<const Device*,int> m_rowByDevice;
+    QHash<const Device*,Keys> m_keys;
+
+    void index(int row);
+    void unindex(const Device *device);
+};
+
 class DeviceModel: public QAbstractListModel
 {
     Q_OBJECT
@@ -111,7 +151,7 @@ private:
     void clearAdapter();
     void setAdapterFromPath(const QString &objectPath);
 
-    QList<QSharedPointer<Device> > m_devices;
+    DeviceStore m_devices;
     void updateDevices();
     void addDevice(QSharedPointer<Device> &device);
     void addDevice(const QString &objectPath);
@@ -17,20 +17,33 @@
  */
 
 #include <applicationenvironment.h>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDBusAbstractAdaptor>
 
 #include "bluetoothmanager.h"
+#include "../logger.h"
+#include "../tracing.h"
+
+namespace
+{
+  // Device updates arriving within one frame are delivered to the page as
+  // a single batch
+  const int DEVICE_EVENTS_FLUSH_INTERVAL_MSEC = 16;
+}
 
 BluetoothManager::BluetoothManager(luna::ApplicationEnvironment *environment, QObject *parent) :
     luna::BaseExtension("BluetoothManager", environment, parent),
     mManager(0),
     mTechnology(0),
     mBluetooth(0),
-    mBtAgent(0)
+    mBtAgent(0),
+    mDeviceEventsTimer(this)
 {
+    mDeviceEventsTimer.setSingleShot(true);
+    mDeviceEventsTimer.setInterval(DEVICE_EVENTS_FLUSH_INTERVAL_MSEC);
+    connect(&mDeviceEventsTimer, SIGNAL(timeout()), this, SLOT(flushDeviceEvents()));
+
     mManager = NetworkManagerFactory::createInstance();
     connect(mManager, SIGNAL(technologiesChanged()), this, SLOT(technologiesChanged()));
 
@@ -64,7 +77,7 @@ BluetoothManager::BluetoothManager(luna::ApplicationEnvironment *environment, QO
     connect(mBtAgent, SIGNAL(pairingDone()),
             this, SLOT(pairingDone()));
 
-    qDebug() << "Registering BluetoothManager extension ...";
+    qCDebug(luna::lcExtension) << "Registering BluetoothManager extension ...";
     environment->registerUserScript(QString("://extensions/BluetoothManager.js"));
 }
 
@@ -76,7 +89,7 @@ BluetoothManager::~BluetoothManager()
 void BluetoothManager::initialize()
 {
     bool Powered = mTechnology ? mTechnology->powered() : false;
-    mAppEnvironment->executeScript(QString("__BluetoothManager.setPowered(%1);").arg(Powered ? "true" : "false"));
+    sendEvent("setPowered", QJsonArray() << QJsonValue(Powered));
 }
 
 void BluetoothManager::connectBtSignals()
@@ -87,7 +100,7 @@ void BluetoothManager::connectBtSignals()
 void BluetoothManager::setPowered(bool powered)
 {
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -96,8 +109,10 @@ void BluetoothManager::setPowered(bool powered)
 
 void BluetoothManager::discover(bool value)
 {
+    TRACE_SCOPE("bluetooth", "BluetoothManager::discover");
+
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -110,9 +125,11 @@ void BluetoothManager::discover(bool value)
 
 void BluetoothManager::connectDevice(const QString &address)
 {
-    qDebug() << __PRETTY_FUNCTION__ << address;
+    TRACE_SCOPE("bluetooth", "BluetoothManager::connectDevice");
+
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << address;
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -121,9 +138,9 @@ void BluetoothManager::connectDevice(const QString &address)
 
 void BluetoothManager::disconnectDevice(const QString &address)
 {
-    qDebug() << __PRETTY_FUNCTION__ << address;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << address;
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -133,9 +150,9 @@ void BluetoothManager::disconnectDevice(const QString &address)
 
 void BluetoothManager::removeDevice(const QString &address)
 {
-    qDebug() << __PRETTY_FUNCTION__ << address;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << address;
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -146,7 +163,7 @@ void BluetoothManager::removeDevice(const QString &address)
 void BluetoothManager::resetDevicesList()
 {
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -157,7 +174,7 @@ void BluetoothManager::resetDevicesList()
 void BluetoothManager::providePinCode(uint tag, bool provided, const QString &code)
 {
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -167,7 +184,7 @@ void BluetoothManager::providePinCode(uint tag, bool provided, const QString &co
 void BluetoothManager::providePasskey(uint tag, bool provided, const uint passkey)
 {
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -177,7 +194,7 @@ void BluetoothManager::providePasskey(uint tag, bool provided, const uint passke
 void BluetoothManager::confirmPasskey(uint tag, bool confirmed)
 {
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -187,7 +204,7 @@ void BluetoothManager::confirmPasskey(uint tag, bool confirmed)
 void BluetoothManager::displayPasskeyCallback(uint tag)
 {
     if (!mTechnology) {
-        qDebug() << "Bluetooth is not available";
+        qCDebug(luna::lcExtension) << "Bluetooth is not available";
         return;
     }
 
@@ -196,81 +213,63 @@ void BluetoothManager::displayPasskeyCallback(uint tag)
 
 void BluetoothManager::pinCodeNeeded(int tag, Device* device)
 {
-    qDebug() << __PRETTY_FUNCTION__ << device->getAddress();
-
-    QJsonDocument document;
-
-        QJsonObject btObj;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << device->getAddress();
 
-        btObj.insert("name", QJsonValue(device->getName()));
-        btObj.insert("address", QJsonValue(device->getAddress()));
-        btObj.insert("type", QJsonValue(device->getType()));
-        btObj.insert("tag", QJsonValue(tag));
+    QJsonObject btObj;
+    btObj.insert("name", QJsonValue(device->getName()));
+    btObj.insert("address", QJsonValue(device->getAddress()));
+    btObj.insert("type", QJsonValue(device->getType()));
+    btObj.insert("tag", QJsonValue(tag));
 
-    document.setObject(btObj);
-    QString payload = document.toJson();
-    mAppEnvironment->executeScript(QString("__BluetoothManager.requestPinCode(%1);").arg(payload));
+    sendEvent("requestPinCode", QJsonArray() << btObj);
 }
 
 void BluetoothManager::passkeyNeeded(int tag, Device* device)
 {
-    qDebug() << __PRETTY_FUNCTION__ << device->getAddress();
-
-    QJsonDocument document;
-
-        QJsonObject btObj;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << device->getAddress();
 
-        btObj.insert("name", QJsonValue(device->getName()));
-        btObj.insert("address", QJsonValue(device->getAddress()));
-        btObj.insert("type", QJsonValue(device->getType()));
-        btObj.insert("tag", QJsonValue(tag));
+    QJsonObject btObj;
+    btObj.insert("name", QJsonValue(device->getName()));
+    btObj.insert("address", QJsonValue(device->getAddress()));
+    btObj.insert("type", QJsonValue(device->getType()));
+    btObj.insert("tag", QJsonValue(tag));
 
-    document.setObject(btObj);
-    QString payload = document.toJson();
-    mAppEnvironment->executeScript(QString("__BluetoothManager.requestPasskey(%1);").arg(payload));
+    sendEvent("requestPasskey", QJsonArray() << btObj);
 }
 
 void BluetoothManager::passkeyConfirmationNeeded(int tag, Device* device, QString passkey)
 {
-    qDebug() << __PRETTY_FUNCTION__ << device->getAddress();
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << device->getAddress();
 
-    QJsonDocument document;
+    QJsonObject btObj;
+    btObj.insert("name", QJsonValue(device->getName()));
+    btObj.insert("address", QJsonValue(device->getAddress()));
+    btObj.insert("type", QJsonValue(device->getType()));
+    btObj.insert("tag", QJsonValue(tag));
+    btObj.insert("passkey", QJsonValue(passkey));
 
-        QJsonObject btObj;
-
-        btObj.insert("name", QJsonValue(device->getName()));
-        btObj.insert("address", QJsonValue(device->getAddress()));
-        btObj.insert("type", QJsonValue(device->getType()));
-        btObj.insert("tag", QJsonValue(tag));
-        btObj.insert("passkey", QJsonValue(passkey));
-
-    document.setObject(btObj);
-    QString payload = document.toJson();
-    mAppEnvironment->executeScript(QString("__BluetoothManager.requestConfirmPasskey(%1);").arg(payload));
+    sendEvent("requestConfirmPasskey", QJsonArray() << btObj);
 }
 
 void BluetoothManager::displayPasskeyNeeded(int tag, Device* device, QString passkey, ushort entered)
 {
-    qDebug() << __PRETTY_FUNCTION__ << device->getAddress() << entered;
-
-    QJsonDocument document;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << device->getAddress() << entered;
 
-        QJsonObject btObj;
+    QJsonObject btObj;
+    btObj.insert("name", QJsonValue(device->getName()));
+    btObj.insert("address", QJsonValue(device->getAddress()));
+    btObj.insert("type", QJsonValue(device->getType()));
+    btObj.insert("tag", QJsonValue(tag));
+    btObj.insert("passkey", QJsonValue(passkey));
+    btObj.insert("entered", QJsonValue(entered));
 
-        btObj.insert("name", QJsonValue(device->getName()));
-        btObj.insert("address", QJsonValue(device->getAddress()));
-        btObj.insert("type", QJsonValue(device->getType()));
-        btObj.insert("tag", QJsonValue(tag));
-        btObj.insert("passkey", QJsonValue(passkey));
-        btObj.insert("entered", QJsonValue(entered));
-
-    document.setObject(btObj);
-    QString payload = document.toJson();
-    mAppEnvironment->executeScript(QString("__BluetoothManager.requestDisplayPasskey(%1);").arg(payload));
+    sendEvent("requestDisplayPasskey", QJsonArray() << btObj);
 }
 
 void BluetoothManager::technologiesChanged()
 {
+    TRACE_SCOPE("bluetooth", "BluetoothManager::technologiesChanged");
+
     if (mTechnology && mManager->getTechnology("bluetooth") == NULL) {
         mTechnology = NULL;
         initialize();
@@ -284,72 +283,102 @@ void BluetoothManager::technologiesChanged()
     }
 }
 
-void BluetoothManager::deviceFound(QSharedPointer<Device> &device)
+QJsonObject BluetoothManager::deviceToJson(const Device *device) const
 {
-    QJsonDocument document;
-
-        QJsonObject btObj;
+    QJsonObject btObj;
+    btObj.insert("name", QJsonValue(device->getName()));
+    btObj.insert("address", QJsonValue(device->getAddress()));
+    btObj.insert("type", QJsonValue(device->getType()));
+    btObj.insert("paired", QJsonValue(device->isPaired()));
+    btObj.insert("trusted", QJsonValue(device->isTrusted()));
+    btObj.insert("connection", QJsonValue(device->getConnection()));
+    btObj.insert("strength", QJsonValue(device->getStrength()));
+
+    return btObj;
+}
 
-        btObj.insert("name", QJsonValue(device->getName()));
-        btObj.insert("address", QJsonValue(device->getAddress()));
-        btObj.insert("type", QJsonValue(device->getType()));
-        btObj.insert("paired", QJsonValue(device->isPaired()));
-        btObj.insert("trusted", QJsonValue(device->isTrusted()));
-        btObj.insert("connection", QJsonValue(device->getConnection()));
-        btObj.insert("strength", QJsonValue(device->getStrength()));
+void BluetoothManager::queueDeviceEvent(const QSharedPointer<Device> &device, bool found)
+{
+    const QString &address = device->getAddress();
+
+    auto it = mPendingDeviceEvents.find(address);
+    if (it == mPendingDeviceEvents.end()) {
+        PendingDeviceEvent event;
+        event.device = device;
+        event.found = found;
+        mPendingDeviceEvents.insert(address, event);
+        mPendingDeviceAddresses.append(address);
+    } else {
+        // a device the page didn't hear about yet stays a found event
+        it->device = device;
+        it->found = it->found || found;
+    }
 
-    document.setObject(btObj);
-    QString payload = document.toJson();
-    mAppEnvironment->executeScript(QString("__BluetoothManager.deviceFound(%1);").arg(payload));
+    // don't restart a running timer so a busy discovery still gets
+    // flushed once per interval
+    if (!mDeviceEventsTimer.isActive())
+        mDeviceEventsTimer.start();
 }
 
-void BluetoothManager::deviceChanged(QSharedPointer<Device> &device)
+void BluetoothManager::flushDeviceEvents()
 {
-    QJsonDocument document;
+    TRACE_SCOPE("bluetooth", "BluetoothManager::flushDeviceEvents");
+
+    if (mPendingDeviceAddresses.isEmpty())
+        return;
+
+    QJsonArray devicesArray;
 
-        QJsonObject btObj;
+    Q_FOREACH(const QString &address, mPendingDeviceAddresses) {
+        const PendingDeviceEvent &event = mPendingDeviceEvents[address];
 
-        btObj.insert("name", QJsonValue(device->getName()));
-        btObj.insert("address", QJsonValue(device->getAddress()));
-        btObj.insert("type", QJsonValue(device->getType()));
-        btObj.insert("paired", QJsonValue(device->isPaired()));
-        btObj.insert("trusted", QJsonValue(device->isTrusted()));
-        btObj.insert("connection", QJsonValue(device->getConnection()));
-        btObj.insert("strength", QJsonValue(device->getStrength()));
+        QJsonObject eventObj;
+        eventObj.insert("event", QJsonValue(QString(event.found ? "found" : "changed")));
+        eventObj.insert("device", deviceToJson(event.device.data()));
+        devicesArray.append(eventObj);
+    }
+
+    mPendingDeviceAddresses.clear();
+    mPendingDeviceEvents.clear();
 
-    document.setObject(btObj);
-    QString payload = document.toJson();
-    mAppEnvironment->executeScript(QString("__BluetoothManager.deviceChanged(%1);").arg(payload));
+    sendEvent("devicesChanged", QJsonArray() << devicesArray);
+}
+
+void BluetoothManager::deviceFound(QSharedPointer<Device> &device)
+{
+    queueDeviceEvent(device, true);
+}
+
+void BluetoothManager::deviceChanged(QSharedPointer<Device> &device)
+{
+    queueDeviceEvent(device, false);
 }
 
 void BluetoothManager::deviceRemoved(QString address)
 {
-    mAppEnvironment->executeScript(QString("__BluetoothManager.deviceRemoved(%1);").arg(address));
+    // the page has to hear about the device before it goes away
+    flushDeviceEvents();
+
+    sendEvent("deviceRemoved", QJsonArray() << QJsonValue(address));
 }
 
 void BluetoothManager::deviceDisappeared(QString address)
 {
-    mAppEnvironment->executeScript(QString("__BluetoothManager.deviceDisappeared(%1);").arg(address));
+    flushDeviceEvents();
+
+    sendEvent("deviceDisappeared", QJsonArray() << QJsonValue(address));
 }
 
 void BluetoothManager::propertyChanged(const QString &key, const QVariant &value)
 {
     if (value.type() == QVariant::Bool)
-    {
-	mAppEnvironment->executeScript(
-	    QString("__BluetoothManager.propertyChanged(\"%1\",%2);").
-	    arg(key, value.toBool() ? "true" : "false"));
-    }
+        sendEvent("propertyChanged", QJsonArray() << QJsonValue(key) << QJsonValue(value.toBool()));
     else // Assume QString
-    {
-	mAppEnvironment->executeScript(
-	    QString("__BluetoothManager.propertyChanged(\"%1\",\"%2\");").
-	    arg(key, value.toString()));
-    }
+        sendEvent("propertyChanged", QJsonArray() << QJsonValue(key) << QJsonValue(value.toString()));
 }
 
 void BluetoothManager::pairingDone()
 {
-    mAppEnvironment->executeScript(QString("__BluetoothManager.pairingDone();"));
+    sendEvent("pairingDone");
 }
 
@@ -21,6 +21,10 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+#include <QJsonObject>
 #include <networkmanager.h>
 #include <networktechnology.h>
 #include <networkservice.h>
@@ -66,13 +70,27 @@ private Q_SLOTS:
     void displayPasskeyNeeded(int tag, Device* device, QString passkey, ushort entered);
     void pairingDone();
 
+    void flushDeviceEvents();
+
 private:
     NetworkManager *mManager;
     NetworkTechnology *mTechnology;
     Bluetooth *mBluetooth;
     Agent *mBtAgent;
 
+    struct PendingDeviceEvent
+    {
+        QSharedPointer<Device> device;
+        bool found;
+    };
+
+    QTimer mDeviceEventsTimer;
+    QStringList mPendingDeviceAddresses;
+    QHash<QString, PendingDeviceEvent> mPendingDeviceEvents;
+
     void connectBtSignals();
+    void queueDeviceEvent(const QSharedPointer<Device> &device, bool found);
+    QJsonObject deviceToJson(const Device *device) const;
 };
 
 #endif // BLUETOOTHMANAGER_H
@@ -21,19 +21,23 @@
 #include <glib.h>
 #include <lunaprefs.h>
 
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonValue>
-
 #include <Settings.h>
 
+#include "../jsonwriter.h"
+
 static DeviceInfo* s_instance = 0;
 static const int kTouchableHeight = 48;
 
+void* DeviceInfo::createInstance(void*)
+{
+    return new DeviceInfo;
+}
+
+// The startup gathers the info on a worker thread while apps may already ask for it
 DeviceInfo* DeviceInfo::instance()
 {
-    if (G_UNLIKELY(s_instance == 0))
-        new DeviceInfo;
+    static GOnce once = G_ONCE_INIT;
+    g_once(&once, createInstance, NULL);
 
     return s_instance;
 }
@@ -144,27 +148,27 @@ void DeviceInfo::gatherInfo()
 
     // Compose json string from the parameters  -------------------------------
 
-    QJsonObject root;
-
-    root.insert("modelName", QJsonValue(QString::fromStdString(m_modelName)));
-    root.insert("modelNameAscii", QJsonValue(QString::fromStdString(m_modelNameAscii)));
-    root.insert("platformVersion", QJsonValue(QString::fromStdString(m_platformVersion)));
-    root.insert("platformVersionMajor", QJsonValue((int) m_platformVersionMajor));
-    root.insert("platformVersionMinor", QJsonValue((int) m_platformVersionMinor));
-    root.insert("platformVersionDot", QJsonValue((int) m_platformVersionDot));
-    root.insert("carrierName", QJsonValue(QString::fromStdString(m_carrierName)));
-    root.insert("serialNumber", QJsonValue(QString::fromStdString(m_serialNumber)));
+    luna::JsonWriter root;
 
-    root.insert("wifiAvailable", QJsonValue(m_wifiAvailable));
-    root.insert("bluetoothAvailable", QJsonValue(m_bluetoothAvailable));
-    root.insert("carrierAvailable", QJsonValue(carrierAvailable()));
+    root.beginObject();
+    root.member("modelName", m_modelName.c_str());
+    root.member("modelNameAscii", m_modelNameAscii.c_str());
+    root.member("platformVersion", m_platformVersion.c_str());
+    root.member("platformVersionMajor", (int) m_platformVersionMajor);
+    root.member("platformVersionMinor", (int) m_platformVersionMinor);
+    root.member("platformVersionDot", (int) m_platformVersionDot);
+    root.member("carrierName", m_carrierName.c_str());
+    root.member("serialNumber", m_serialNumber.c_str());
 
-    root.insert("swappableBattery", QJsonValue(m_swappableBattery));
-    root.insert("dockModeEnabled", QJsonValue(true));
+    root.member("wifiAvailable", m_wifiAvailable);
+    root.member("bluetoothAvailable", m_bluetoothAvailable);
+    root.member("carrierAvailable", carrierAvailable());
 
-    QJsonDocument document(root);
+    root.member("swappableBattery", m_swappableBattery);
+    root.member("dockModeEnabled", true);
+    root.endObject();
 
-    m_jsonString = document.toJson();
+    m_jsonString = QString::fromUtf8(root.data());
 }
 
 bool DeviceInfo::keyboardSlider() const
@@ -47,6 +47,7 @@ public:
 
 private:
     DeviceInfo();
+    static void* createInstance(void*);
 
     void gatherInfo();
 
@@ -18,9 +18,11 @@
 #include <QUrl>
 #include <QQmlComponent>
 #include <QQuickItem>
+#include <QJsonArray>
 
 #include "../webapplicationwindow.h"
 #include "inappbrowserextension.h"
+#include "../logger.h"
 
 namespace luna
 {
@@ -47,7 +49,7 @@ void InAppBrowserExtension::open(const QString &url, const QString &frameName)
     if (mApplicationWindow->headless())
         return;
 
-    qDebug() << Q_FUNC_INFO << url << frameName;
+    qCDebug(lcExtension) << Q_FUNC_INFO << url << frameName;
 
     QQmlComponent component(mApplicationWindow->qmlEngine(),
                             QUrl("qrc:///qml/InAppBrowser.qml"));
@@ -72,14 +74,14 @@ void InAppBrowserExtension::close()
 
 void InAppBrowserExtension::onDone(const QString &frameName)
 {
-    mAppEnvironment->executeScript(QString("__InAppBrowser.userClickedDone(\"%1\");").arg(frameName));
+    sendEvent("userClickedDone", QJsonArray() << QJsonValue(frameName));
     close();
 }
 
 void InAppBrowserExtension::onTitleChanged(const QString &frameName)
 {
     QString title = mItem->property("title").toString();
-    mAppEnvironment->executeScript(QString("__InAppBrowser.setTitle(\"%1\",\"%2\");").arg(title).arg(frameName));
+    sendEvent("setTitle", QJsonArray() << QJsonValue(title) << QJsonValue(frameName));
 }
 
 } // namespace luna
@@ -25,6 +25,8 @@
 #include <QtWebEngineVersion>
 #include <QMap>
 
+#include <string.h>
+
 #include <luna-service2/lunaservice.h>
 #include <luna-service2++/message.hpp>
 #include <luna-service2++/call.hpp>
@@ -37,40 +39,95 @@
 #include "../webappmanager.h"
 #include "../webappmanagerservice.h"
 #include "../systemtime.h"
+#include "../jsonwriter.h"
 #include "palmsystemextension.h"
 #include "deviceinfo.h"
+#include "../logger.h"
+#include "../tracing.h"
+#include "../bridgestats.h"
 
 namespace luna
 {
 
-// little utility to return one application service per iAppId
+// Hands out one application service per iAppId, shared by all the windows of
+// the app. Once the last window of an app is gone its handle is parked in a
+// small idle pool, so an app closed and relaunched right away doesn't have to
+// register again, and dropped for good when it falls out of the pool.
 class LunaAppServicesManager {
 public:
-    LS::Handle &getAppService(const QString &iAppServiceName, const QString &iAppId) {
-        if (!mapAppServiceName.contains(iAppId)) {
+    LS::Handle *acquire(const QString &iAppServiceName, const QString &iAppId) {
+        if (mapAppServices.contains(iAppId)) {
+            AppService &service = mapAppServices[iAppId];
+            service.refCount++;
+            return service.handle;
+        }
+
+        LS::Handle *handle = 0;
+        for (int i = 0; i < idleAppServices.size(); ++i) {
+            if (idleAppServices.at(i).first == iAppId) {
+                handle = idleAppServices.takeAt(i).second;
+                break;
+            }
+        }
+
+        // a failure isn't remembered, the next window of the app tries again
+        if (!handle) {
             try {
-                mapAppServiceName[iAppId] = new LS::Handle(iAppServiceName.toUtf8().constData(), iAppId.toUtf8().constData());
+                handle = new LS::Handle(iAppServiceName.toUtf8().constData(), iAppId.toUtf8().constData());
+                handle->attachToLoop(g_main_context_default());
             }  catch (LS::Error &error) {
-                mapAppServiceName[iAppId] = new LS::Handle();
+                qCWarning(lcBridge) << "Failed to register application service for" << iAppId;
+                delete handle;
+                return 0;
             }
         }
 
-        return *(mapAppServiceName[iAppId]);
+        AppService service;
+        service.handle = handle;
+        service.refCount = 1;
+        mapAppServices.insert(iAppId, service);
+
+        return handle;
+    }
+
+    void release(const QString &iAppId) {
+        if (!mapAppServices.contains(iAppId))
+            return;
+
+        AppService &service = mapAppServices[iAppId];
+        if (--service.refCount > 0)
+            return;
+
+        idleAppServices.prepend(qMakePair(iAppId, service.handle));
+        mapAppServices.remove(iAppId);
+
+        while (idleAppServices.size() > MaxIdleAppServices)
+            delete idleAppServices.takeLast().second;
     }
 
     ~LunaAppServicesManager() {
-        for(auto h: mapAppServiceName.values()) {
-            if(h) delete h;
-        }
+        for(auto service: mapAppServices.values())
+            delete service.handle;
+        for(auto idle: idleAppServices)
+            delete idle.second;
     }
 private:
-    QMap<QString, LS::Handle*> mapAppServiceName;
+    enum { MaxIdleAppServices = 4 };
+
+    struct AppService {
+        LS::Handle *handle;
+        int refCount;
+    };
+
+    QMap<QString, AppService> mapAppServices;
+    // most recently released first
+    QList<QPair<QString, LS::Handle*> > idleAppServices;
 } _lunaAppServicesManager;
 
 PalmSystemExtension::PalmSystemExtension(WebApplicationWindow *applicationWindow, QObject *parent) :
     BaseExtension("PalmSystem", applicationWindow, parent),
     mApplicationWindow(applicationWindow),
-    mLunaAppHandle(_lunaAppServicesManager.getAppService(applicationWindow->application()->identifier(), applicationWindow->application()->id()))
+    mLunaAppHandle(0)
 {
     applicationWindow->registerUserScript(QString("://extensions/PalmSystem.js"), false);
     applicationWindow->registerUserScript(QString("://extensions/PalmSystemBridge.js"), true);
@@ -80,10 +137,35 @@ PalmSystemExtension::PalmSystemExtension(WebApplicationWindow *applicationWindow
     }
 
     connect(applicationWindow, SIGNAL(activeChanged()), this, SIGNAL(isActivatedChanged()));
-    
-    try {
-        mLunaAppHandle.attachToLoop(g_main_context_default());
-    }  catch (LS::Error &error) {}
+
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    if (pWebAppManager && pWebAppManager->getService())
+        connect(&pWebAppManager->getService()->bridgeTrace(), SIGNAL(enabledChanged(const QString&, bool)),
+                this, SLOT(onBridgeTracingChanged(const QString&, bool)));
+
+    getAppHandle();
+}
+
+PalmSystemExtension::~PalmSystemExtension()
+{
+    // calls still open when the window goes, i.e. subscriptions, end here
+    for (QHash<int, PalmServiceBridgeObject>::iterator it = mListBridges.begin(); it != mListBridges.end(); ++it)
+        finishBridgeCall(it.value(), false);
+
+    // the pending bridge calls need the handle to cancel themselves
+    mListBridges.clear();
+
+    if (mLunaAppHandle)
+        _lunaAppServicesManager.release(mApplicationWindow->application()->id());
+}
+
+LS::Handle *PalmSystemExtension::getAppHandle()
+{
+    if (!mLunaAppHandle)
+        mLunaAppHandle = _lunaAppServicesManager.acquire(mApplicationWindow->application()->identifier(),
+                                                         mApplicationWindow->application()->id());
+
+    return mLunaAppHandle;
 }
 
 LS::Handle &PalmSystemExtension::getLunaHandle()
@@ -92,53 +174,53 @@ LS::Handle &PalmSystemExtension::getLunaHandle()
     if(pWebAppManager && pWebAppManager->getService()) return pWebAppManager->getService()->getServiceHandle();
     
     // fallback on application service
-    return mLunaAppHandle;
+    return *getAppHandle();
 }
 
 void PalmSystemExtension::stageReady()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__;
     mApplicationWindow->stageReady();
 }
 
 void PalmSystemExtension::activate()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__;
     mApplicationWindow->focus();
 }
 
 void PalmSystemExtension::deactivate()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__;
     mApplicationWindow->unfocus();
 }
 
 void PalmSystemExtension::stagePreparing()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__;
     mApplicationWindow->stagePreparing();
 }
 
 void PalmSystemExtension::show()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__;
     mApplicationWindow->show();
 }
 
 void PalmSystemExtension::hide()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__;
     mApplicationWindow->hide();
 }
 
 void PalmSystemExtension::setWindowProperties(const QString &properties)
 {
-    qDebug() << __PRETTY_FUNCTION__ << properties;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__ << properties;
 }
 
 void PalmSystemExtension::enableFullScreenMode(bool enable)
 {
-    qDebug() << __PRETTY_FUNCTION__ << enable;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__ << enable;
 
     QString appId = mApplicationWindow->application()->identifier();
     QString enableStr = enable ? "true" : "false";
@@ -152,7 +234,7 @@ void PalmSystemExtension::enableFullScreenMode(bool enable)
 
 void PalmSystemExtension::removeBannerMessage(int id)
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__;
 
     QString appId = mApplicationWindow->application()->identifier();
 
@@ -165,7 +247,7 @@ void PalmSystemExtension::removeBannerMessage(int id)
 
 void PalmSystemExtension::clearBannerMessages()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__;
 
     QString appId = mApplicationWindow->application()->identifier();
 
@@ -177,7 +259,7 @@ void PalmSystemExtension::clearBannerMessages()
 
 void PalmSystemExtension::keepAlive(bool keep)
 {
-    qDebug() << __PRETTY_FUNCTION__ << keep;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__ << keep;
     mApplicationWindow->setKeepAlive(keep);
 }
 
@@ -281,16 +363,40 @@ QString PalmSystemExtension::version()
     return QString(QTWEBENGINE_VERSION_STR);
 }
 
+bool PalmSystemExtension::bridgeTracing()
+{
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    if (!pWebAppManager || !pWebAppManager->getService())
+        return false;
+
+    return pWebAppManager->getService()->bridgeTrace().isEnabled(mApplicationWindow->application()->id());
+}
+
+void PalmSystemExtension::onBridgeTracingChanged(const QString &appId, bool enabled)
+{
+    if (appId == mApplicationWindow->application()->id())
+        emit bridgeTracingChanged();
+}
+
+void PalmSystemExtension::reportBridgeTrace(const QJsonArray &records)
+{
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    if (!pWebAppManager || !pWebAppManager->getService())
+        return;
+
+    pWebAppManager->getService()->bridgeTrace().addRecords(mApplicationWindow->application()->id(), records);
+}
+
 QString PalmSystemExtension::getResource(const QString&resPath, const QString &)
 {
-    qDebug() << __PRETTY_FUNCTION__ << resPath;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__ << resPath;
 
     QString path = resPath;
     if (path.startsWith("file://"))
         path = path.right(path.size() - 7);
 
     if (!mApplicationWindow->application()->validateResourcePath(path)) {
-        qDebug() << "WARNING: Access to path" << path << "is not allowed";
+        qCDebug(lcBridge) << "WARNING: Access to path" << path << "is not allowed";
         return QString("");
     }
 
@@ -305,7 +411,7 @@ QString PalmSystemExtension::getResource(const QString&resPath, const QString &)
 
 QString PalmSystemExtension::getIdentifierForFrame(const QString&id, const QString &url)
 {
-    qDebug() << __PRETTY_FUNCTION__ << id << ", " << url;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__ << id << ", " << url;
 
     return mApplicationWindow->getIdentifierForFrame(id, url);
 }
@@ -315,29 +421,30 @@ QString PalmSystemExtension::addBannerMessage(const QString &msgTitle, const QSt
                                               const QString &msgSoundFile, int duration,
                                               bool doNotSuppress)
 {
-    qDebug() << __PRETTY_FUNCTION__ << msgTitle << ":" << launchParams;
+    qCDebug(lcBridge) << __PRETTY_FUNCTION__ << msgTitle << ":" << launchParams;
 
     QString appId = mApplicationWindow->application()->identifier();
 
     QString iconUrl = msgIconUrl;
     QString soundFile = msgSoundFile;
-    QJsonObject notificationParams;
-    
-    notificationParams.insert("title", msgTitle);
-    notificationParams.insert("launchParams", launchParams);
-    notificationParams.insert("iconUrl", iconUrl);
-    notificationParams.insert("soundClass", soundClass);
-    notificationParams.insert("soundFile", soundFile);
-    notificationParams.insert("duration", duration);
-    notificationParams.insert("doNotSuppress", doNotSuppress);
-    notificationParams.insert("expireTimeout", "0");
-
-    QJsonDocument document(notificationParams);
+    JsonWriter notificationParams;
+
+    notificationParams.beginObject();
+    notificationParams.member("title", msgTitle);
+    notificationParams.member("launchParams", launchParams);
+    notificationParams.member("iconUrl", iconUrl);
+    notificationParams.member("soundClass", soundClass);
+    notificationParams.member("soundFile", soundFile);
+    notificationParams.member("duration", duration);
+    notificationParams.member("doNotSuppress", doNotSuppress);
+    notificationParams.member("expireTimeout", "0");
+    notificationParams.endObject();
+
     QJsonObject response;
 
     try {
         LS::Call call = getLunaHandle().callOneReply("luna://org.webosports.notifications/create",
-                                                    document.toJson().constData(),
+                                                    notificationParams.constData(),
                                                     appId.toUtf8().constData());
         LS::Message message(call.get(1000));
 
@@ -352,30 +459,102 @@ QString PalmSystemExtension::addBannerMessage(const QString &msgTitle, const QSt
 
 void PalmSystemExtension::LS2Call(int callId, int bridgeId, const QString &uri, const QString &payload)
 {
+    LogScope logScope(mApplicationWindow->application()->id(), mApplicationWindow->windowId());
+    TRACE_SCOPE("bridge", "PalmSystemExtension::LS2Call");
+
     PalmServiceBridgeObject &lBridgeObject = mListBridges[bridgeId]; // this will create a new PalmServiceBridgeObject if needed
+    // a new call on the same bridge replaces the previous one
+    finishBridgeCall(lBridgeObject, false);
     lBridgeObject.bridgeId = bridgeId;
     lBridgeObject.callId = callId;
+    lBridgeObject.traceFlowId = Tracer::nextFlowId();
+
+    // links the call with its replies in the trace
+    TRACE_FLOW_BEGIN("bridge", "LS2Call", lBridgeObject.traceFlowId);
     lBridgeObject.palmExt = this;
 
+    BridgeStats *stats = bridgeStats();
+    QString appId = mApplicationWindow->application()->id();
+
+    LS::Handle *appHandle = getAppHandle();
+    if (!appHandle) {
+        if (stats)
+            stats->callFailed(appId, uri);
+        callback(callId, false, true, "{\"returnValue\":false,\"errorText\":\"Application is not connected to the bus\"}");
+        return;
+    }
+
     try {
-        lBridgeObject.currentBridgeCall.reset(new LS::Call(mLunaAppHandle.callMultiReply(uri.toLatin1().data(),
+        lBridgeObject.callTimer.start();
+        lBridgeObject.currentBridgeCall.reset(new LS::Call(appHandle->callMultiReply(uri.toLatin1().data(),
                                                                                          payload.toLatin1().data(),
                                                                                          &replyCallback, &lBridgeObject)));
-    }  catch (LS::Error &error) {}
+        lBridgeObject.uri = uri;
+        lBridgeObject.replyCount = 0;
+        if (stats)
+            stats->callStarted(appId, uri, payload.size());
+    }  catch (LS::Error &error) {
+        qCWarning(lcBridge) << "Failed to call" << uri << ":" << error.what();
+        if (stats)
+            stats->callFailed(appId, uri);
+
+        // the page waits for an answer, tell it the call never went out
+        QJsonObject response;
+        response.insert("returnValue", false);
+        response.insert("errorText", QString::fromUtf8(error.what()));
+        callback(callId, false, true, QString::fromUtf8(QJsonDocument(response).toJson(QJsonDocument::Compact)));
+    }
 }
 
 void PalmSystemExtension::LS2Cancel(int bridgeId)
 {
     PalmServiceBridgeObject &lBridgeObject = mListBridges[bridgeId]; // this will create a new PalmServiceBridgeObject if needed
+    finishBridgeCall(lBridgeObject, true);
     lBridgeObject.currentBridgeCall->cancel();
 }
 
+BridgeStats *PalmSystemExtension::bridgeStats()
+{
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    if (!pWebAppManager || !pWebAppManager->getService())
+        return 0;
+
+    return &pWebAppManager->getService()->bridgeStats();
+}
+
+void PalmSystemExtension::finishBridgeCall(PalmServiceBridgeObject &bridgeObject, bool cancelled)
+{
+    if (bridgeObject.uri.isEmpty())
+        return;
+
+    BridgeStats *stats = bridgeStats();
+    if (stats)
+        stats->callFinished(mApplicationWindow->application()->id(), bridgeObject.uri,
+                            bridgeObject.replyCount, cancelled);
+
+    bridgeObject.uri.clear();
+}
+
 bool PalmSystemExtension::PalmServiceBridgeObject::handleReply(LSHandle *sh, LSMessage *reply)
 {
+    TRACE_SCOPE("bridge", "PalmSystemExtension::handleReply");
+    TRACE_FLOW_STEP("bridge", "LS2Call", traceFlowId);
+
     if(reply && palmExt)
     {
         LS::Message _reply(reply);
-        palmExt->callback(callId, true, true, _reply.getPayload());
+        const char *payload = _reply.getPayload();
+
+        BridgeStats *stats = palmExt->bridgeStats();
+        if (stats && !uri.isEmpty()) {
+            replyCount++;
+            // only the first reply tells how long the service took to answer
+            qint64 latency = replyCount == 1 ? callTimer.nsecsElapsed() / 1000 : -1;
+            stats->replyReceived(palmExt->mApplicationWindow->application()->id(), uri,
+                                 payload ? strlen(payload) : 0, latency);
+        }
+
+        palmExt->callback(callId, true, true, payload);
     }
 
     return true;
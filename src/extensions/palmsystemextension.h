@@ -18,6 +18,7 @@
 #ifndef PALMSYSTEMPLUGIN_H
 #define PALMSYSTEMPLUGIN_H
 
+#include <QElapsedTimer>
 #include <QString>
 #include <QSharedPointer>
 
@@ -28,6 +29,7 @@ namespace luna
 {
 
 class WebApplicationWindow;
+class BridgeStats;
 
 class PalmSystemExtension : public BaseExtension
 {
@@ -50,8 +52,10 @@ class PalmSystemExtension : public BaseExtension
     Q_PROPERTY(int activityId READ activityId CONSTANT)
     Q_PROPERTY(QString phoneRegion READ phoneRegion CONSTANT)
     Q_PROPERTY(QString version READ version CONSTANT)
+    Q_PROPERTY(bool bridgeTracing READ bridgeTracing NOTIFY bridgeTracingChanged)
 public:
     explicit PalmSystemExtension(WebApplicationWindow *applicationWindow, QObject *parent = 0);
+    ~PalmSystemExtension();
 
     Q_INVOKABLE QString getResource(const QString&resPath, const QString &);
     Q_INVOKABLE QString getIdentifierForFrame(const QString&id, const QString &url);
@@ -63,6 +67,8 @@ public:
     Q_INVOKABLE void LS2Call(int callId, int bridgeId, const QString &uri, const QString &payload);
     Q_INVOKABLE void LS2Cancel(int bridgeId);
 
+    Q_INVOKABLE void reportBridgeTrace(const QJsonArray &records);
+
 public Q_SLOTS:
 
     void activate();
@@ -141,19 +147,25 @@ public Q_SLOTS:
     int     activityId();
     QString phoneRegion();
     QString version();
+    bool    bridgeTracing();
 
 Q_SIGNALS:
     void hasAlphaHoleChanged();
     void windowOrientationChanged();
     void isActivatedChanged();
     void launchParamsChanged(bool needRelaunch);
+    void bridgeTracingChanged();
 
     void palmBridgeServiceCall(QString body);
+private Q_SLOTS:
+    void onBridgeTracingChanged(const QString &appId, bool enabled);
+
 private:
     WebApplicationWindow *mApplicationWindow;
-    LS::Handle &mLunaAppHandle;
+    LS::Handle *mLunaAppHandle;
 
     LS::Handle &getLunaHandle();
+    LS::Handle *getAppHandle();
 
     class PalmServiceBridgeObject {
     public:
@@ -161,28 +173,46 @@ private:
             bridgeId(0),
             callId(0),
             palmExt(nullptr),
-            currentBridgeCall(nullptr) {}
+            currentBridgeCall(nullptr),
+            traceFlowId(0),
+            replyCount(0) {}
         PalmServiceBridgeObject(const PalmServiceBridgeObject &other):
             bridgeId(other.bridgeId),
             callId(other.callId),
             palmExt(other.palmExt),
-            currentBridgeCall(other.currentBridgeCall) {}
+            currentBridgeCall(other.currentBridgeCall),
+            traceFlowId(other.traceFlowId),
+            uri(other.uri),
+            replyCount(other.replyCount),
+            callTimer(other.callTimer) {}
         PalmServiceBridgeObject &operator=(const PalmServiceBridgeObject &other) {
             bridgeId = other.bridgeId;
             callId = other.callId;
             palmExt = other.palmExt;
             currentBridgeCall = other.currentBridgeCall;
+            traceFlowId = other.traceFlowId;
+            uri = other.uri;
+            replyCount = other.replyCount;
+            callTimer = other.callTimer;
             return *this;
         }
         int bridgeId;
         int callId;
         PalmSystemExtension *palmExt;
         QSharedPointer<LS::Call> currentBridgeCall;
+        quint64 traceFlowId;
+        // set while a call is in flight, for the bridge statistics
+        QString uri;
+        int replyCount;
+        QElapsedTimer callTimer;
 
         bool handleReply(LSHandle *sh, LSMessage *reply);
     };
     QHash<int, PalmServiceBridgeObject> mListBridges;
 
+    BridgeStats *bridgeStats();
+    void finishBridgeCall(PalmServiceBridgeObject &bridgeObject, bool cancelled);
+
     static bool replyCallback(LSHandle* sh, LSMessage* reply, void* context);
 };
 
@@ -22,6 +22,30 @@
 #include <QDBusAbstractAdaptor>
 
 #include "wifimanager.h"
+#include "../logger.h"
+#include "../tracing.h"
+
+namespace
+{
+  // Strength changes smaller than this are not reported to the page unless
+  // something else about the network changed as well
+  const int STRENGTH_HYSTERESIS = 5;
+
+  bool networkDiffers(const QJsonObject &reported, const QJsonObject &current)
+  {
+      for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+          if (it.key() == "strength") {
+              if (qAbs(it.value().toInt() - reported.value("strength").toInt()) >= STRENGTH_HYSTERESIS)
+                  return true;
+          }
+          else if (reported.value(it.key()) != it.value()) {
+              return true;
+          }
+      }
+
+      return false;
+  }
+}
 
 WiFiManager::WiFiManager(luna::ApplicationEnvironment *environment, QObject *parent) :
     luna::BaseExtension("WiFiManager", environment, parent),
@@ -47,14 +71,39 @@ WiFiManager::WiFiManager(luna::ApplicationEnvironment *environment, QObject *par
     connect(&mAgent, SIGNAL(userInputRequested(const QString&, const QVariantMap&)),
             this, SLOT(handleUserInputRequested(const QString&, const QVariantMap&)));
 
-    qDebug() << "Registering WiFiManager extension ...";
+    qCDebug(luna::lcExtension) << "Registering WiFiManager extension ...";
     environment->registerUserScript(QString("://extensions/WiFiManager.js"));
 }
 
 void WiFiManager::initialize()
 {
     bool wifiPowered = mWifi ? mWifi->powered() : false;
-    mAppEnvironment->executeScript(QString("__WiFiManager.setPowered(%1);").arg(wifiPowered ? "true" : "false"));
+    sendEvent("setPowered", QJsonArray() << QJsonValue(wifiPowered));
+
+    // the page starts from scratch so give it the complete list once, all
+    // further updates are sent as differences to it
+    sendNetworksSnapshot();
+}
+
+void WiFiManager::sendNetworksSnapshot()
+{
+    TRACE_SCOPE("wifi", "WiFiManager::sendNetworksSnapshot");
+
+    mNetworks.clear();
+    mNetworkOrder.clear();
+
+    QJsonArray networksArray;
+
+    foreach(NetworkService *network, mManager->getServices("wifi")) {
+        QJsonObject networkObj = createNetworkObject(network);
+        mNetworks.insert(network->path(), networkObj);
+        mNetworkOrder.append(network->path());
+        networksArray.append(networkObj);
+    }
+
+    TRACE_COUNTER("wifi", "networks", mNetworks.size());
+
+    sendEvent("networksChanged", QJsonArray() << networksArray);
 }
 
 void WiFiManager::connectWifiSignals()
@@ -69,12 +118,61 @@ void WiFiManager::managerAvailabilityChanged(bool available)
 
 void WiFiManager::servicesChanged()
 {
-    QString payload = createNetworksResponse();
-    mAppEnvironment->executeScript(QString("__WiFiManager.networksChanged(%1);").arg(payload));
+    TRACE_SCOPE("wifi", "WiFiManager::servicesChanged");
+
+    QJsonArray addedArray;
+    QJsonArray changedArray;
+    QJsonArray removedArray;
+    QHash<QString, QJsonObject> previousNetworks;
+    QStringList previousOrder;
+
+    previousNetworks.swap(mNetworks);
+    previousOrder.swap(mNetworkOrder);
+
+    foreach(NetworkService *network, mManager->getServices("wifi")) {
+        QJsonObject networkObj = createNetworkObject(network);
+        QString path = network->path();
+        mNetworkOrder.append(path);
+
+        auto it = previousNetworks.find(path);
+        if (it == previousNetworks.end()) {
+            addedArray.append(networkObj);
+            mNetworks.insert(path, networkObj);
+        }
+        else if (networkDiffers(it.value(), networkObj)) {
+            changedArray.append(networkObj);
+            mNetworks.insert(path, networkObj);
+        }
+        else {
+            // keep what the page knows so small strength changes add up
+            mNetworks.insert(path, it.value());
+        }
+
+        if (it != previousNetworks.end())
+            previousNetworks.erase(it);
+    }
+
+    foreach(const QString &path, previousNetworks.keys())
+        removedArray.append(QJsonValue(path));
+
+    // connman sorts by state and strength, a reordering alone is worth telling
+    if (addedArray.isEmpty() && changedArray.isEmpty() && removedArray.isEmpty() &&
+        mNetworkOrder == previousOrder)
+        return;
+
+    QJsonObject diffObj;
+    diffObj.insert("added", addedArray);
+    diffObj.insert("changed", changedArray);
+    diffObj.insert("removed", removedArray);
+    diffObj.insert("order", QJsonArray::fromStringList(mNetworkOrder));
+
+    sendEvent("networksUpdated", QJsonArray() << diffObj);
 }
 
 void WiFiManager::technologiesChanged()
 {
+    TRACE_SCOPE("wifi", "WiFiManager::technologiesChanged");
+
     if (mWifi && mManager->getTechnology("wifi") == NULL) {
         mWifi = NULL;
         initialize();
@@ -88,42 +186,46 @@ void WiFiManager::technologiesChanged()
     }
 }
 
+QJsonObject WiFiManager::createNetworkObject(NetworkService *network) const
+{
+    QJsonObject networkObj;
+
+    networkObj.insert("path", QJsonValue(network->path()));
+    networkObj.insert("name", QJsonValue(network->name()));
+    networkObj.insert("state", QJsonValue(network->state()));
+    networkObj.insert("error", QJsonValue(network->error()));
+
+    QJsonArray securityArray;
+    foreach(QString securityType, network->security())
+        securityArray.append(QJsonValue(securityType));
+    networkObj.insert("security", securityArray);
+
+    networkObj.insert("strength", QJsonValue((int) network->strength()));
+    networkObj.insert("favorite", QJsonValue(network->favorite()));
+    networkObj.insert("autoconnect", QJsonValue(network->autoConnect()));
+    networkObj.insert("connected", QJsonValue(network->connected()));
+    networkObj.insert("roaming", QJsonValue(network->roaming()));
+
+    // FIXME add the following missing parts
+    // - ipv4/ipv6 configuration
+    // - nameservers
+    // - domains
+    // - proxy configuration
+
+    return networkObj;
+}
+
 QString WiFiManager::createNetworksResponse()
 {
     QJsonDocument document;
     QJsonArray networksArray;
 
-    foreach(NetworkService *network, mManager->getServices("wifi")) {
-        QJsonObject networkObj;
-
-        networkObj.insert("path", QJsonValue(network->path()));
-        networkObj.insert("name", QJsonValue(network->name()));
-        networkObj.insert("state", QJsonValue(network->state()));
-        networkObj.insert("error", QJsonValue(network->error()));
-
-        QJsonArray securityArray;
-        foreach(QString securityType, network->security())
-            securityArray.append(QJsonValue(securityType));
-        networkObj.insert("security", securityArray);
-
-        networkObj.insert("strength", QJsonValue((int) network->strength()));
-        networkObj.insert("favorite", QJsonValue(network->favorite()));
-        networkObj.insert("autoconnect", QJsonValue(network->autoConnect()));
-        networkObj.insert("connected", QJsonValue(network->connected()));
-        networkObj.insert("roaming", QJsonValue(network->roaming()));
-
-        // FIXME add the following missing parts
-        // - ipv4/ipv6 configuration
-        // - nameservers
-        // - domains
-        // - proxy configuration
-
-        networksArray.append(QJsonValue(networkObj));
-    }
+    foreach(NetworkService *network, mManager->getServices("wifi"))
+        networksArray.append(QJsonValue(createNetworkObject(network)));
 
     document.setArray(networksArray);
 
-    return document.toJson();
+    return document.toJson(QJsonDocument::Compact);
 }
 
 void WiFiManager::scanFinished()
@@ -138,7 +240,7 @@ void WiFiManager::scanFinished()
 
 void WiFiManager::handleUserInputRequested(const QString &servicePath, const QVariantMap &fields)
 {
-    qDebug() << __PRETTY_FUNCTION__ << servicePath << fields;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << servicePath << fields;
 
     if (!mConnecting)
         return;
@@ -165,6 +267,8 @@ void WiFiManager::setPowered(bool powered)
 
 void WiFiManager::retrieveNetworks(int callId)
 {
+    TRACE_SCOPE("wifi", "WiFiManager::retrieveNetworks");
+
     if (!mWifi) {
         callback(callId, false, false, "WiFi is not available");
         return;
@@ -175,16 +279,26 @@ void WiFiManager::retrieveNetworks(int callId)
     mWifi->scan();
 }
 
+void WiFiManager::getNetworks(int callId)
+{
+    if (!mWifi) {
+        callback(callId, false, false, "WiFi is not available");
+        return;
+    }
+
+    callback(callId, false, true, createNetworksResponse());
+}
+
 void WiFiManager::connectRequestFailed(const QString& error)
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__;
 
     finishConnectionProcess(false, error);
 }
 
 void WiFiManager::networkConnected(bool connected)
 {
-    qDebug() << __PRETTY_FUNCTION__ << connected;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << connected;
 
     bool success = false;
 
@@ -196,7 +310,7 @@ void WiFiManager::networkConnected(bool connected)
 
 void WiFiManager::finishConnectionProcess(bool success, const QString &error)
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__;
 
     if (mConnecting)
         callback(mConnectCallbacks, false, success, error);
@@ -219,7 +333,9 @@ void WiFiManager::finishConnectionProcess(bool success, const QString &error)
 
 void WiFiManager::connectNetwork(int callId, const QString &network)
 {
-    qDebug() << __PRETTY_FUNCTION__ << network;
+    TRACE_SCOPE("wifi", "WiFiManager::connectNetwork");
+
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << network;
 
     if (mConnecting) {
         callback(callId, false /*keepCallback*/, false /*success*/, "Already connecting to a network");
@@ -270,7 +386,7 @@ void WiFiManager::connectNetwork(int callId, const QString &network)
 
 void WiFiManager::disconnectNetwork(const QString &path)
 {
-    qDebug() << __PRETTY_FUNCTION__ << path;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << path;
 
     if (mConnecting)
         return;
@@ -283,7 +399,7 @@ void WiFiManager::disconnectNetwork(const QString &path)
 
 void WiFiManager::setNetworkOption(const QString &path, const QString &key, const QVariant &value)
 {
-    qDebug() << __PRETTY_FUNCTION__ << path << key << value;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << path << key << value;
 
     QVariantMap emptyProperties;
     NetworkService networkToConfigure(path, emptyProperties, 0);
@@ -291,7 +407,7 @@ void WiFiManager::setNetworkOption(const QString &path, const QString &key, cons
 
 void WiFiManager::removeNetwork(const QString &path)
 {
-    qDebug() << __PRETTY_FUNCTION__ << path;
+    qCDebug(luna::lcExtension) << __PRETTY_FUNCTION__ << path;
 
     QVariantMap emptyProperties;
     NetworkService networkToRemove(path, emptyProperties, 0);
@@ -20,6 +20,9 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QJsonObject>
+#include <QStringList>
 #include <networkmanager.h>
 #include <networktechnology.h>
 #include <networkservice.h>
@@ -37,6 +40,7 @@ public:
 public Q_SLOTS:
     void setPowered(bool powered);
     void retrieveNetworks(int callId);
+    void getNetworks(int callId);
     void connectNetwork(int callId, const QString &network);
     void disconnectNetwork(const QString &path);
     void setNetworkOption(const QString &path, const QString &key, const QVariant &value);
@@ -63,9 +67,14 @@ private:
     UserAgent mAgent;
     QString mNetworkPassword;
     QString mNetworkName;
+    QHash<QString, QJsonObject> mNetworks;
+    // paths of the networks in the order connman sorts them
+    QStringList mNetworkOrder;
 
     void connectWifiSignals();
     void finishConnectionProcess(bool success, const QString &error);
+    void sendNetworksSnapshot();
+    QJsonObject createNetworkObject(NetworkService *network) const;
     QString createNetworksResponse();
 };
 
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLocale>
+
+#include <cmath>
+#include <string.h>
+
+#include "jsonwriter.h"
+
+namespace luna
+{
+
+JsonWriter::JsonWriter() :
+    mBuffer(&mOwnBuffer),
+    mAfterKey(false)
+{
+}
+
+JsonWriter::JsonWriter(QByteArray *buffer) :
+    mBuffer(buffer),
+    mAfterKey(false)
+{
+    // resize instead of clear to keep the allocation around
+    mBuffer->resize(0);
+}
+
+void JsonWriter::separate()
+{
+    if (mAfterKey) {
+        mAfterKey = false;
+        return;
+    }
+
+    if (mFirst.isEmpty())
+        return;
+
+    if (mFirst.last())
+        mFirst.last() = false;
+    else
+        mBuffer->append(',');
+}
+
+JsonWriter &JsonWriter::beginObject()
+{
+    separate();
+    mBuffer->append('{');
+    mFirst.append(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject()
+{
+    mFirst.removeLast();
+    mBuffer->append('}');
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray()
+{
+    separate();
+    mBuffer->append('[');
+    mFirst.append(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray()
+{
+    mFirst.removeLast();
+    mBuffer->append(']');
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(const char *name)
+{
+    separate();
+    appendString(name);
+    mBuffer->append(':');
+    mAfterKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const QString &value)
+{
+    separate();
+    appendString(value);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const char *value)
+{
+    separate();
+    appendString(value);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(bool value)
+{
+    separate();
+    mBuffer->append(value ? "true" : "false");
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(int value)
+{
+    separate();
+    mBuffer->append(QByteArray::number(value));
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(qint64 value)
+{
+    separate();
+    mBuffer->append(QByteArray::number(value));
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(double value)
+{
+    if (!std::isfinite(value))
+        return nullValue();
+
+    separate();
+    mBuffer->append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        return this->value(value.toBool());
+    case QJsonValue::Double:
+        {
+            const double d = value.toDouble();
+            if (d == std::floor(d) && std::fabs(d) < 9007199254740992.0)
+                return this->value((qint64) d);
+            return this->value(d);
+        }
+    case QJsonValue::String:
+        return this->value(value.toString());
+    case QJsonValue::Array:
+        return rawValue(QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact));
+    case QJsonValue::Object:
+        return rawValue(QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact));
+    default:
+        return nullValue();
+    }
+}
+
+JsonWriter &JsonWriter::nullValue()
+{
+    separate();
+    mBuffer->append("null");
+    return *this;
+}
+
+JsonWriter &JsonWriter::rawValue(const QByteArray &json)
+{
+    separate();
+    mBuffer->append(json);
+    return *this;
+}
+
+void JsonWriter::appendAscii(char c)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    switch (c) {
+    case '"':
+        mBuffer->append("\\\"");
+        break;
+    case '\\':
+        mBuffer->append("\\\\");
+        break;
+    case '\b':
+        mBuffer->append("\\b");
+        break;
+    case '\f':
+        mBuffer->append("\\f");
+        break;
+    case '\n':
+        mBuffer->append("\\n");
+        break;
+    case '\r':
+        mBuffer->append("\\r");
+        break;
+    case '\t':
+        mBuffer->append("\\t");
+        break;
+    default:
+        if ((unsigned char) c < 0x20) {
+            mBuffer->append("\\u00");
+            mBuffer->append(hexDigits[(c >> 4) & 0xf]);
+            mBuffer->append(hexDigits[c & 0xf]);
+        }
+        else {
+            mBuffer->append(c);
+        }
+        break;
+    }
+}
+
+void JsonWriter::appendString(const char *str)
+{
+    // the input is expected to be UTF-8 already, only escaping is needed
+    mBuffer->append('"');
+    for (const char *c = str; *c; ++c)
+        appendAscii(*c);
+    mBuffer->append('"');
+}
+
+void JsonWriter::appendString(const QString &str)
+{
+    QByteArray &out = *mBuffer;
+    const ushort *c = str.utf16();
+    const ushort *end = c + str.size();
+
+    out.reserve(out.size() + str.size() + 2);
+    out.append('"');
+
+    // encode UTF-16 to UTF-8 on the fly to avoid a temporary QByteArray
+    for (; c != end; ++c) {
+        uint u = *c;
+
+        if (u < 0x80) {
+            appendAscii(char(u));
+        }
+        else if (u < 0x800) {
+            out.append(char(0xc0 | (u >> 6)));
+            out.append(char(0x80 | (u & 0x3f)));
+        }
+        else if (QChar::isHighSurrogate(u) && c + 1 != end && QChar::isLowSurrogate(c[1])) {
+            u = QChar::surrogateToUcs4(ushort(u), c[1]);
+            ++c;
+            out.append(char(0xf0 | (u >> 18)));
+            out.append(char(0x80 | ((u >> 12) & 0x3f)));
+            out.append(char(0x80 | ((u >> 6) & 0x3f)));
+            out.append(char(0x80 | (u & 0x3f)));
+        }
+        else {
+            out.append(char(0xe0 | (u >> 12)));
+            out.append(char(0x80 | ((u >> 6) & 0x3f)));
+            out.append(char(0x80 | (u & 0x3f)));
+        }
+    }
+
+    out.append('"');
+}
+
+} // namespace luna
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVarLengthArray>
+
+class QJsonValue;
+
+namespace luna
+{
+
+/*
+ * Streams compact JSON straight into a UTF-8 buffer. Used on the service
+ * and bridge paths where building a QJsonObject and serializing it through
+ * QJsonDocument costs more than the message is worth.
+ *
+ * A writer constructed on an external buffer truncates it but keeps its
+ * capacity, so a buffer kept by the caller is reused between messages.
+ */
+class JsonWriter
+{
+public:
+    JsonWriter();
+    explicit JsonWriter(QByteArray *buffer);
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    JsonWriter &beginArray();
+    JsonWriter &endArray();
+
+    JsonWriter &key(const char *name);
+
+    JsonWriter &value(const QString &value);
+    JsonWriter &value(const char *value);
+    JsonWriter &value(bool value);
+    JsonWriter &value(int value);
+    JsonWriter &value(qint64 value);
+    JsonWriter &value(double value);
+    JsonWriter &value(const QJsonValue &value);
+    JsonWriter &nullValue();
+    JsonWriter &rawValue(const QByteArray &json);
+
+    template<typename T>
+    JsonWriter &member(const char *name, const T &v) { return key(name).value(v); }
+
+    const QByteArray &data() const { return *mBuffer; }
+    const char *constData() const { return mBuffer->constData(); }
+    int size() const { return mBuffer->size(); }
+
+private:
+    QByteArray mOwnBuffer;
+    QByteArray *mBuffer;
+    // one entry per open object/array, true until its first element
+    QVarLengthArray<bool, 8> mFirst;
+    bool mAfterKey;
+
+    void separate();
+    void appendString(const QString &str);
+    void appendString(const char *str);
+    void appendAscii(char c);
+
+    Q_DISABLE_COPY(JsonWriter)
+};
+
+} // namespace luna
+
+#endif // JSONWRITER_H
@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <QDateTime>
+#include <QTime>
+
+#include <stdio.h>
+#include <sys/uio.h>
+#include <syslog.h>
+
+#include <systemd/sd-journal.h>
+
+#include "logger.h"
+
+#define WRITER_IDLE_WAIT_MSEC 100
+
+namespace luna
+{
+
+Q_LOGGING_CATEGORY(lcManager, "webappmanager.manager")
+Q_LOGGING_CATEGORY(lcApplication, "webappmanager.application")
+Q_LOGGING_CATEGORY(lcWindow, "webappmanager.window")
+Q_LOGGING_CATEGORY(lcBridge, "webappmanager.bridge")
+Q_LOGGING_CATEGORY(lcExtension, "webappmanager.extension")
+
+namespace
+{
+
+__thread const LogScope *currentScope = 0;
+
+const char *levelNames[] = { "debug", "info", "warning", "critical" };
+
+int syslogPriority(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return LOG_DEBUG;
+    case QtInfoMsg:
+        return LOG_INFO;
+    case QtWarningMsg:
+        return LOG_WARNING;
+    case QtCriticalMsg:
+        return LOG_CRIT;
+    default:
+        return LOG_EMERG;
+    }
+}
+
+const char *typePrefix(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return "DEBUG";
+    case QtWarningMsg:
+        return "WARNING";
+    case QtCriticalMsg:
+        return "CRITICAL";
+    case QtFatalMsg:
+        return "FATAL";
+    default:
+        return "INFO";
+    }
+}
+
+} // namespace
+
+Logger* Logger::instance()
+{
+    static Logger* instance = 0;
+
+    if (!instance)
+        instance = new Logger();
+
+    return instance;
+}
+
+Logger::Logger() :
+    mEnqueuePos(0),
+    mDequeuePos(0),
+    mDropped(0),
+    mWriterSleeping(false),
+    mRunning(false),
+    // systemd tells its services where their output goes
+    mJournal(!qgetenv("JOURNAL_STREAM").isEmpty()),
+    mVerbose(false)
+{
+    for (size_t n = 0; n < RingSize; n++)
+        mRing[n].sequence.store(n, std::memory_order_relaxed);
+}
+
+void Logger::install()
+{
+    updateFilterRules();
+
+    mRunning = true;
+    mWriter = std::thread(&Logger::writerLoop, this);
+
+    qInstallMessageHandler(Logger::messageHandler);
+}
+
+void Logger::shutdown()
+{
+    if (!mRunning)
+        return;
+
+    mRunning = false;
+    mWakeup.notify_one();
+    mWriter.join();
+
+    // anything logged from now on is written right away
+    drain();
+}
+
+void Logger::setVerbose(bool verbose)
+{
+    mVerbose = verbose;
+    updateFilterRules();
+}
+
+bool Logger::setLevel(const QString &category, const QString &level)
+{
+    bool known = false;
+    for (size_t n = 0; n < sizeof(levelNames) / sizeof(levelNames[0]); n++)
+        known = known || level == levelNames[n];
+
+    if (!known)
+        return false;
+
+    mLevels.insert(category, level);
+    updateFilterRules();
+
+    return true;
+}
+
+void Logger::updateFilterRules()
+{
+    QString rules = QString("*.debug=%1\n").arg(mVerbose ? "true" : "false");
+
+    // later rules take precedence, so the more specific categories go last
+    for (QMap<QString, QString>::const_iterator it = mLevels.constBegin(); it != mLevels.constEnd(); ++it) {
+        bool enabled = false;
+        for (size_t n = 0; n < sizeof(levelNames) / sizeof(levelNames[0]); n++) {
+            enabled = enabled || it.value() == levelNames[n];
+            QString value = enabled ? "true" : "false";
+            rules += QString("%1.%2=%3\n").arg(it.key()).arg(levelNames[n]).arg(value);
+            if (it.key() != "*")
+                rules += QString("%1.*.%2=%3\n").arg(it.key()).arg(levelNames[n]).arg(value);
+        }
+    }
+
+    QLoggingCategory::setFilterRules(rules);
+}
+
+void Logger::messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    Logger *logger = instance();
+
+    if (type != QtFatalMsg && logger->mRunning && logger->enqueue(type, context, msg))
+        return;
+
+    // fatal messages have to be out before we abort
+    Entry entry;
+    entry.type = type;
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch() * 1000;
+    entry.category = context.category;
+    entry.file = context.file;
+    entry.line = context.line;
+    entry.function = context.function;
+    entry.message = msg.toUtf8();
+    entry.windowId = currentScope ? currentScope->windowId() : 0;
+    if (currentScope)
+        entry.appId = currentScope->appId();
+
+    logger->write(entry);
+}
+
+// Bounded multi-producer queue: every slot carries the position it can be
+// written at next, so producers only have to agree on a position.
+bool Logger::enqueue(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+    Entry *entry;
+
+    for (;;) {
+        entry = &mRing[pos % RingSize];
+        size_t sequence = entry->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t) sequence - (intptr_t) pos;
+
+        if (diff == 0) {
+            if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0) {
+            // the writer is behind, rather lose the message than block
+            mDropped++;
+            if (mWriterSleeping.load(std::memory_order_relaxed))
+                mWakeup.notify_one();
+            return true;
+        }
+        else {
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    entry->type = type;
+    entry->timestamp = QDateTime::currentMSecsSinceEpoch() * 1000;
+    entry->category = context.category;
+    entry->file = context.file;
+    entry->line = context.line;
+    entry->function = context.function;
+    entry->message = msg.toUtf8();
+    entry->windowId = currentScope ? currentScope->windowId() : 0;
+    entry->appId = currentScope ? currentScope->appId() : QByteArray();
+
+    entry->sequence.store(pos + 1, std::memory_order_release);
+
+    // warnings shouldn't wait for the writer's next round
+    if (type != QtDebugMsg && mWriterSleeping.load(std::memory_order_relaxed))
+        mWakeup.notify_one();
+
+    return true;
+}
+
+void Logger::writerLoop()
+{
+    while (mRunning) {
+        drain();
+
+        std::unique_lock<std::mutex> lock(mWakeupMutex);
+        mWriterSleeping = true;
+        mWakeup.wait_for(lock, std::chrono::milliseconds(WRITER_IDLE_WAIT_MSEC));
+        mWriterSleeping = false;
+    }
+}
+
+void Logger::drain()
+{
+    for (;;) {
+        Entry &entry = mRing[mDequeuePos % RingSize];
+        if (entry.sequence.load(std::memory_order_acquire) != mDequeuePos + 1)
+            break;
+
+        write(entry);
+        entry.message.clear();
+        entry.appId.clear();
+
+        entry.sequence.store(mDequeuePos + RingSize, std::memory_order_release);
+        mDequeuePos++;
+    }
+
+    unsigned int dropped = mDropped.exchange(0);
+    if (dropped > 0) {
+        Entry entry;
+        entry.type = QtWarningMsg;
+        entry.timestamp = QDateTime::currentMSecsSinceEpoch() * 1000;
+        entry.category = "default";
+        entry.file = 0;
+        entry.line = 0;
+        entry.function = 0;
+        entry.message = QString("%1 log messages were dropped").arg(dropped).toUtf8();
+        entry.windowId = 0;
+        write(entry);
+    }
+}
+
+void Logger::write(const Entry &entry)
+{
+    if (!mJournal) {
+        QTime time = QDateTime::fromMSecsSinceEpoch(entry.timestamp / 1000).time();
+        fprintf(stderr, "%s: %s: %s\n", typePrefix(entry.type),
+                time.toString("hh:mm:ss.zzz").toUtf8().constData(), entry.message.constData());
+        return;
+    }
+
+    QByteArray fields[8];
+    int count = 0;
+
+    fields[count++] = "MESSAGE=" + entry.message;
+    fields[count++] = "PRIORITY=" + QByteArray::number(syslogPriority(entry.type));
+    fields[count++] = QByteArray("WAM_CATEGORY=") + (entry.category ? entry.category : "default");
+    if (!entry.appId.isEmpty())
+        fields[count++] = "WAM_APP_ID=" + entry.appId;
+    if (entry.windowId)
+        fields[count++] = "WAM_WINDOW_ID=" + QByteArray::number(entry.windowId);
+    if (entry.file) {
+        fields[count++] = QByteArray("CODE_FILE=") + entry.file;
+        fields[count++] = "CODE_LINE=" + QByteArray::number(entry.line);
+    }
+    if (entry.function)
+        fields[count++] = QByteArray("CODE_FUNC=") + entry.function;
+
+    struct iovec iov[8];
+    for (int n = 0; n < count; n++) {
+        iov[n].iov_base = (void*) fields[n].constData();
+        iov[n].iov_len = fields[n].size();
+    }
+
+    sd_journal_sendv(iov, count);
+}
+
+LogScope::LogScope(const QString &appId, int windowId) :
+    mAppId(appId.toUtf8()),
+    mWindowId(windowId),
+    mPrevious(currentScope)
+{
+    currentScope = this;
+}
+
+LogScope::~LogScope()
+{
+    currentScope = mPrevious;
+}
+
+const LogScope *LogScope::current()
+{
+    return currentScope;
+}
+
+} // namespace luna
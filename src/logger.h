@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <QByteArray>
+#include <QLoggingCategory>
+#include <QMap>
+#include <QString>
+
+namespace luna
+{
+
+Q_DECLARE_LOGGING_CATEGORY(lcManager)
+Q_DECLARE_LOGGING_CATEGORY(lcApplication)
+Q_DECLARE_LOGGING_CATEGORY(lcWindow)
+Q_DECLARE_LOGGING_CATEGORY(lcBridge)
+Q_DECLARE_LOGGING_CATEGORY(lcExtension)
+
+/*
+ * Message handler handing the log messages to a writer thread.
+ *
+ * The calling thread only copies the message into a preallocated ring, the
+ * writer sends it to journald with the category and, when known, the app and
+ * window it concerns as separate fields. Messages logged while the ring is
+ * full are dropped and counted. Which levels are logged can be changed per
+ * category at runtime.
+ */
+class Logger
+{
+public:
+    static Logger* instance();
+
+    void install();
+    void shutdown();
+
+    void setVerbose(bool verbose);
+    bool setLevel(const QString &category, const QString &level);
+    QMap<QString, QString> levels() const { return mLevels; }
+
+private:
+    Logger();
+
+    struct Entry
+    {
+        std::atomic<size_t> sequence;
+        QtMsgType type;
+        qint64 timestamp;
+        const char *category;
+        const char *file;
+        int line;
+        const char *function;
+        QByteArray message;
+        QByteArray appId;
+        int windowId;
+    };
+
+    enum { RingSize = 1024 };
+
+    Entry mRing[RingSize];
+    std::atomic<size_t> mEnqueuePos;
+    size_t mDequeuePos;
+    std::atomic<unsigned int> mDropped;
+
+    std::thread mWriter;
+    std::mutex mWakeupMutex;
+    std::condition_variable mWakeup;
+    std::atomic<bool> mWriterSleeping;
+    std::atomic<bool> mRunning;
+    bool mJournal;
+
+    bool mVerbose;
+    QMap<QString, QString> mLevels;
+
+    static void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg);
+
+    bool enqueue(QtMsgType type, const QMessageLogContext &context, const QString &msg);
+    void write(const Entry &entry);
+    void writerLoop();
+    void drain();
+    void updateFilterRules();
+};
+
+/*
+ * Marks the messages logged by the current thread while it exists as
+ * belonging to the given app and window.
+ */
+class LogScope
+{
+public:
+    LogScope(const QString &appId, int windowId = 0);
+    ~LogScope();
+
+    static const LogScope *current();
+
+    QByteArray appId() const { return mAppId; }
+    int windowId() const { return mWindowId; }
+
+private:
+    QByteArray mAppId;
+    int mWindowId;
+    const LogScope *mPrevious;
+};
+
+} // namespace luna
+
+#endif // LOGGER_H
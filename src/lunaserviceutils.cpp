@@ -16,7 +16,10 @@
 *
 * LICENSE@@@ */
 
+#include <stdio.h>
+
 #include "lunaserviceutils.h"
+#include "logger.h"
 
 void luna_service_message_reply_custom_error(LSHandle *handle, LSMessage *message, const char *error_text)
 {
@@ -74,47 +77,66 @@ void luna_service_message_reply_success(LSHandle *handle, LSMessage *message)
 	}
 }
 
+/* Compile a schema once so messages can be validated while they are parsed.
+ * Returns NULL if the schema itself is invalid. */
+jschema_ref luna_service_compile_schema(const char *schema)
+{
+	jschema_ref compiled = jschema_parse(j_cstr_to_buffer(schema), DOMOPT_NOOPT, NULL);
+
+	if (!compiled)
+		qCWarning(luna::lcManager) << "Failed to compile schema" << schema;
+
+	return compiled;
+}
+
 jvalue_ref luna_service_message_parse_and_validate(const char *payload)
 {
-	jschema_ref input_schema = NULL;
 	jvalue_ref parsed_obj = NULL;
 	JSchemaInfo schema_info;
 
-	input_schema = jschema_parse(j_cstr_to_buffer("{}"), DOMOPT_NOOPT, NULL);
-	jschema_info_init(&schema_info, input_schema, NULL, NULL);
+	jschema_info_init(&schema_info, jschema_all(), NULL, NULL);
 
 	parsed_obj = jdom_parse(j_cstr_to_buffer(payload), DOMOPT_NOOPT, &schema_info);
 
-	jschema_release(&input_schema);
 	if (jis_null(parsed_obj))
 		return NULL;
 
 	return parsed_obj;
 }
 
+/* Parse the payload and validate it against the schema in a single pass.
+ * Returns NULL unless the payload is an object matching the schema. */
+jvalue_ref luna_service_message_parse_with_schema(const char *payload, jschema_ref schema)
+{
+	jvalue_ref parsed_obj = NULL;
+	JSchemaInfo schema_info;
+
+	jschema_info_init(&schema_info, schema ? schema : jschema_all(), NULL, NULL);
+
+	parsed_obj = jdom_parse(j_cstr_to_buffer(payload), DOMOPT_NOOPT, &schema_info);
+
+	if (!jis_object(parsed_obj)) {
+		j_release(&parsed_obj);
+		return NULL;
+	}
+
+	return parsed_obj;
+}
+
 bool luna_service_message_validate_and_send(LSHandle *handle, LSMessage *message, jvalue_ref reply_obj)
 {
-	jschema_ref response_schema = NULL;
 	LSError lserror;
 	bool success = true;
 
 	LSErrorInit(&lserror);
 
-	response_schema = jschema_parse (j_cstr_to_buffer("{}"), DOMOPT_NOOPT, NULL);
-	if(!response_schema) {
-		luna_service_message_reply_error_internal(handle, message);
-		return false;
-	}
-
 	if (!LSMessageReply(handle, message,
-					jvalue_tostring(reply_obj, response_schema), &lserror)) {
+					jvalue_tostring(reply_obj, jschema_all()), &lserror)) {
 		LSErrorPrint(&lserror, stderr);
 		LSErrorFree(&lserror);
 		success = false;
 	}
 
-	jschema_release(&response_schema);
-
 	return success;
 }
 
@@ -137,24 +159,15 @@ bool luna_service_check_for_subscription_and_process(LSHandle *handle, LSMessage
 
 void luna_service_post_subscription(LSHandle *handle, const char *path, const char *method, jvalue_ref reply_obj)
 {
-	jschema_ref response_schema = NULL;
 	LSError lserror;
 
 	LSErrorInit(&lserror);
 
-	response_schema = jschema_parse (j_cstr_to_buffer("{}"), DOMOPT_NOOPT, NULL);
-	if(!response_schema)
-		goto cleanup;
-
 	if (!LSSubscriptionPost(handle, path, method,
-						jvalue_tostring(reply_obj, response_schema), &lserror)) {
+						jvalue_tostring(reply_obj, jschema_all()), &lserror)) {
 		LSErrorPrint(&lserror, stderr);
 		LSErrorFree(&lserror);
 	}
-
-cleanup:
-	if (response_schema)
-		jschema_release(&response_schema);
 }
 
 // vim:ts=4:sw=4:noexpandtab
@@ -16,8 +16,8 @@
  */
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QStringList>
-#include <QTime>
 #include <QtGlobal>
 
 #include <glib.h>
@@ -28,9 +28,13 @@
 
 #include "webappmanager.h"
 #include "systemtime.h"
+#include "startuppipeline.h"
+#include "logger.h"
+#include "extensions/deviceinfo.h"
 
 #define VERSION "0.1"
 #define XDG_RUNTIME_DIR_DEFAULT "/tmp/luna-session"
+#define MIME_TABLE_TIMEOUT_MSEC 2000
 
 static gboolean option_version = FALSE;
 static gboolean option_verbose = FALSE;
@@ -46,37 +50,15 @@ static GOptionEntry options[] = {
     { NULL },
 };
 
-void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
-{
-    QString timeStr = QTime::currentTime().toString("hh:mm:ss.zzz");
-
-    switch(type)
-    {
-    case QtDebugMsg:
-        if (option_verbose)
-            fprintf(stderr, "DEBUG: %s: %s\n", timeStr.toUtf8().constData(), msg.toUtf8().constData());
-        break;
-    case QtWarningMsg:
-        fprintf(stderr, "WARNING: %s: %s\n", timeStr.toUtf8().constData(), msg.toUtf8().constData());
-        break;
-    case QtCriticalMsg:
-        fprintf(stderr, "CRITICAL: %s: %s\n", timeStr.toUtf8().constData(), msg.toUtf8().constData());
-        break;
-    case QtFatalMsg:
-        fprintf(stderr, "FATAL: %s: %s\n", timeStr.toUtf8().constData(), msg.toUtf8().constData());
-        break;
-    default:
-        fprintf(stderr, "INFO: %s: %s\n", timeStr.toUtf8().constData(), msg.toUtf8().constData());
-        break;
-    }
-}
-
 int main(int argc, char **argv)
 {
     GError *error = NULL;
     GOptionContext *context;
+    QElapsedTimer startupTimer;
+
+    startupTimer.start();
 
-    qInstallMessageHandler(messageHandler);
+    luna::Logger::instance()->install();
 
     if (qgetenv("DISPLAY").isEmpty()) {
         setenv("EGL_PLATFORM", "wayland", 0);
@@ -104,6 +86,8 @@ int main(int argc, char **argv)
 
     luna::WebAppManager webAppManager(argc, argv);
 
+    qCInfo(luna::lcManager, "Web engine and service initialized after %lld ms", startupTimer.elapsed());
+
     context = g_option_context_new(NULL);
     g_option_context_add_main_entries(context, options, NULL);
 
@@ -131,6 +115,8 @@ int main(int argc, char **argv)
     g_option_context_free(context);
     delete[] _argv; _argv = NULL; _argc = 0;
 
+    luna::Logger::instance()->setVerbose(option_verbose);
+
     if (option_version) {
         g_message("LunaWebAppManager %s", VERSION);
         goto cleanup;
@@ -139,15 +125,42 @@ int main(int argc, char **argv)
     if (QFile::exists("/var/luna/dev-mode-enabled"))
         setenv("QTWEBENGINE_REMOTE_DEBUGGING", "1122", 0);
 
-    LocalePreferences::instance();
-    luna::SystemTime::instance();
+    {
+        luna::StartupPipeline startup;
+
+        // everything the worker threads use has to exist before they start
+        startup.run("settings", [] { Settings::LunaSettings(); });
+
+        startup.runConcurrently("device info", [] { DeviceInfo::instance(); });
+
+        startup.beginStage("mime table", MIME_TABLE_TIMEOUT_MSEC);
+        QObject::connect(&webAppManager, &luna::WebAppManager::mimeTableLoaded,
+                         &startup, [&startup] { startup.finishStage("mime table"); });
+        webAppManager.prefetchMimeTable();
+        webAppManager.watchMimeTable();
 
-    if (option_systemd)
-        sd_notify(0, "READY=1");
+        // the system time only holds a bus handle attached to the main
+        // context, its replies are handled on the GUI thread all the same
+        startup.runConcurrently("system time", [] { luna::SystemTime::instance(); });
 
-    webAppManager.exec();
+        // LocalePreferences comes from luna-sysmgr-common, nothing guards its
+        // instance() against the PalmSystem calls on the GUI thread, so it
+        // has to stay on this thread
+        startup.run("locale", [] { LocalePreferences::instance(); });
+
+        // only tell systemd we're there once we can really launch apps
+        QObject::connect(&startup, &luna::StartupPipeline::finished, [] {
+            if (option_systemd)
+                sd_notify(0, "READY=1");
+        });
+
+        startup.start();
+
+        webAppManager.exec();
+    }
 
 cleanup:
+    luna::Logger::instance()->shutdown();
 
     return 0;
 }
@@ -31,7 +31,7 @@ Flickable {
     anchors.fill: parent
 
     property int numRestarts: 0
-    property int maxRestarts: 3
+    property int maxRestarts: webAppWindow.maxRendererRestarts
 
     NetworkManager {
         id: networkManager
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2013 Simon Busch <morphis@gravedo.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+import QtQuick 2.12
+import QtWebEngine 1.4
+import QtWebChannel 1.0
+import LuneOS.Components 1.0
+
+// Container for headless applications. Nobody ever sees them, so this only
+// holds the web view and its channel: no background, no offline panel, no
+// connectivity watcher and no input method handling.
+Item {
+    id: headlessContainer
+
+    property int numRestarts: 0
+    property int maxRestarts: webAppWindow.maxRendererRestarts
+
+    LunaWebEngineView {
+        id: webView
+        objectName: "webView"
+
+        userScripts: webAppWindow.userScripts;
+
+        onNavigationRequested: {
+            var action = WebEngineView.AcceptRequest;
+            var url = request.url.toString();
+
+            if (webApp.urlsAllowed && webApp.urlsAllowed.length !== 0) {
+                action = WebEngineView.IgnoreRequest;
+                for (var i = 0; i < webApp.urlsAllowed.length; ++i) {
+                    var pattern = webApp.urlsAllowed[i];
+                    if (url.match(pattern)) {
+                        action = WebEngineView.AcceptRequest;
+                        break;
+                    }
+                }
+            }
+
+            request.action = action;
+
+            if (request.action === WebEngineView.IgnoreRequest) {
+                Qt.openUrlExternally(url);
+                return;
+            }
+        }
+
+        Component.onCompleted: {
+            webAppWindow.configureWebView(webView);
+            webView.webChannel = webViewChannel;
+
+            if (webApp.userAgent.length > 0)
+                webView.profile.httpUserAgent = webApp.userAgent;
+
+            if (webAppWindow.trustScope === "system") {
+                webView.settings.localContentCanAccessFileUrls = true;
+                webView.settings.localContentCanAccessRemoteUrls = true;
+
+                if (webView.settings.hasOwnProperty("appRuntime"))
+                    webView.settings.appRuntime = !webApp.allowCrossDomainAccess;
+            }
+        }
+
+        WebChannel {
+            id: webViewChannel
+        }
+
+        Connections {
+            target: webAppWindow
+
+            function onJavaScriptExecNeeded(script) {
+                // beware: async call
+                webView.runJavaScript(script);
+            }
+
+            function onExtensionWantsToBeAdded(name, object) {
+                webViewChannel.registerObject(name, object);
+            }
+        }
+
+        onRenderProcessTerminated: {
+            // Whatever the reason, the render process should never stop when we are still alive
+            if (numRestarts < maxRestarts) {
+                console.log("ERROR: The web process has crashed. Restart it ...");
+                webView.url = webAppWindow.url;
+                webView.reload();
+                numRestarts += 1;
+            }
+            else {
+                console.log("CRITICAL: restarted application " + numRestarts
+                            + " times. Closing it now");
+                Qt.quit();
+            }
+        }
+    }
+}
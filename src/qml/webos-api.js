@@ -441,15 +441,84 @@ if (typeof module === 'object') {
 }
 
 var _webOS = {
+    _eventHandlers: {}
 };
 
+// Bridge calls are only measured while tracing was enabled for the app
+// through the webappmanager service, otherwise a call pays for testing
+// _bridgeTracing and nothing else. Records go to the manager in batches.
+var _bridgeTracing = false;
+var _bridgeTraceRecords = [];
+var _bridgeTraceFlushTimer = null;
+var BRIDGE_TRACE_BATCH_SIZE = 32;
+var BRIDGE_TRACE_FLUSH_DELAY = 1000;
+
+function flushBridgeTrace() {
+    if( _bridgeTraceFlushTimer !== null ) {
+        clearTimeout(_bridgeTraceFlushTimer);
+        _bridgeTraceFlushTimer = null;
+    }
+
+    if( _bridgeTraceRecords.length === 0 )
+        return;
+
+    _webOS.objects.PalmSystem.reportBridgeTrace(_bridgeTraceRecords);
+    _bridgeTraceRecords = [];
+}
+
+function traceBridgeCall(method, requestSize, response, start) {
+    var responseSize = 0;
+    if( typeof(response) === "string" )
+        responseSize = response.length;
+    else if( typeof(response) !== "undefined" )
+        responseSize = JSON.stringify(response).length;
+
+    _bridgeTraceRecords.push({
+        method: method,
+        timestamp: Date.now(),
+        latency: performance.now() - start,
+        requestSize: requestSize,
+        responseSize: responseSize
+    });
+
+    if( _bridgeTraceRecords.length >= BRIDGE_TRACE_BATCH_SIZE )
+        flushBridgeTrace();
+    else if( _bridgeTraceFlushTimer === null )
+        _bridgeTraceFlushTimer = setTimeout(flushBridgeTrace, BRIDGE_TRACE_FLUSH_DELAY);
+}
+
+// The extension holds its events back until we listen, so nothing sent
+// while the page and the channel were still coming up gets lost
+_webOS._connectEventHandlers = function(extensionName) {
+    if( !_webOS.objects || !_webOS.objects.hasOwnProperty(extensionName) )
+        return;
+
+    var extensionObj = _webOS.objects[extensionName];
+    extensionObj.extensionEvent.connect(function(name, args) {
+        var handlers = _webOS._eventHandlers[extensionName];
+        if( handlers && typeof(handlers[name]) === "function" )
+            handlers[name].apply(handlers, args);
+    });
+    extensionObj.enableEvents();
+}
+
 var webOSApiChannel = new QWebChannel(qt.webChannelTransport, function(channel) {
     // all published objects are available in channel.objects under
     // the identifier set in their attached WebChannel.id property
     _webOS.objects = channel.objects;
 
+    for (var extensionName in _webOS._eventHandlers)
+        _webOS._connectEventHandlers(extensionName);
+
     // Handle relaunch requests here
     if( _webOS.objects.hasOwnProperty("PalmSystem") ) {
+        _bridgeTracing = _webOS.objects.PalmSystem.bridgeTracing;
+        _webOS.objects.PalmSystem.bridgeTracingChanged.connect(function() {
+            _bridgeTracing = _webOS.objects.PalmSystem.bridgeTracing;
+            if( !_bridgeTracing )
+                flushBridgeTrace();
+        });
+
         _webOS.objects.PalmSystem.launchParamsChanged.connect(function(needRelaunch) {
             if( needRelaunch ) {
                 console.log("relaunchRequested with params '" + _webOS.objects.PalmSystem.launchParams + "'");
@@ -471,16 +540,30 @@ _webOS.exec = function(successCallback, errorCallback, extensionName, functionNa
     if (typeof parameters === 'undefined')
         parameters = [];
 
-    console.log("_webOS.exec("+extensionName+","+functionName+","+JSON.stringify(parameters)+")");
-
     if( _webOS.objects.hasOwnProperty(extensionName) ) {
         var extensionObj = _webOS.objects[extensionName];
         if( extensionObj.hasOwnProperty(functionName) ) {
 
+            var traceStart = 0, requestSize = 0, traceMethod = null;
+            if( _bridgeTracing ) {
+                traceStart = performance.now();
+                requestSize = JSON.stringify(parameters).length;
+                traceMethod = extensionName + "." + functionName;
+                // all service calls go through LS2Call, the uri tells them apart
+                if( functionName === "LS2Call" )
+                    traceMethod += " " + parameters[1];
+            }
+
             var callId = getNextCallId();
             // Create a contextual callback function for this specific call
             var callbackFunction = function(callbackId, keepCallback, success, payload) {
                 if( callbackId === callId ) {
+                    // only the first reply tells the latency of the call
+                    if( traceStart ) {
+                        traceBridgeCall(traceMethod, requestSize, payload, traceStart);
+                        traceStart = 0;
+                    }
+
                     if( success && typeof(successCallback) === "function" ) {
                         successCallback.call(this, payload);
                     }
@@ -518,13 +601,18 @@ _webOS.execWithoutCallback = function(extensionName, functionName, parameters) {
     if (typeof parameters === 'undefined')
         parameters = [];
 
-    console.log("_webOS.execWithoutCallback("+extensionName+","+functionName+","+JSON.stringify(parameters)+")");
-
     if( _webOS.objects.hasOwnProperty(extensionName) ) {
         var extensionObj = _webOS.objects[extensionName];
         if( extensionObj.hasOwnProperty(functionName) ) {
 
-            parameters.push(function (ret) {console.log(functionName + " returned " + ret)});
+            if( _bridgeTracing ) {
+                var traceStart = performance.now();
+                var requestSize = JSON.stringify(parameters).length;
+                parameters.push(function(ret) {
+                    traceBridgeCall(extensionName + "." + functionName, requestSize, ret, traceStart);
+                });
+            }
+
             extensionObj[functionName].apply(this, parameters);
             return true;
         }
@@ -533,6 +621,19 @@ _webOS.execWithoutCallback = function(extensionName, functionName, parameters) {
     return false;
 }
 
+/**
+ * Register the handlers for events sent by an extension. Each event is
+ * dispatched to the handler with the same name as the event.
+ */
+_webOS.subscribeEvents = function(extensionName, handlers) {
+    var connected = _webOS._eventHandlers.hasOwnProperty(extensionName);
+
+    _webOS._eventHandlers[extensionName] = handlers;
+
+    if( !connected )
+        _webOS._connectEventHandlers(extensionName);
+}
+
 /**
  * Get the property of en extension
  * @return property value
@@ -540,7 +641,6 @@ _webOS.execWithoutCallback = function(extensionName, functionName, parameters) {
 _webOS.getProperty = function(extensionName, propertyName) {
     if( _webOS.objects.hasOwnProperty(extensionName) ) {
         var extensionObj = _webOS.objects[extensionName];
-        console.log("_webOS.getProperty ("+extensionName+"."+propertyName+")="+extensionObj[propertyName]);
         return extensionObj[propertyName];
     }
 
@@ -566,14 +666,16 @@ _webOS.execSync = function(extensionName, functionName, parameters) {
     if (typeof parameters === 'undefined')
         parameters = [];
 
-    console.log("_webOS.execSync("+extensionName+","+functionName+","+JSON.stringify(parameters)+")");
-
     var syncFunctionName = functionName + "_Sync";
 
     if( _webOS.objects.hasOwnProperty(extensionName) ) {
         var extensionObj = _webOS.objects[extensionName];
         if( extensionObj.hasOwnProperty(syncFunctionName) ) {
+            var traceStart = _bridgeTracing ? performance.now() : 0;
             var retValue = extensionObj[syncFunctionName].apply(this, parameters);
+            if( traceStart )
+                traceBridgeCall(extensionName + "." + syncFunctionName, JSON.stringify(parameters).length,
+                                retValue, traceStart);
             return retValue;
         }
     }
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <stdlib.h>
+
+#include "rendererprocesspolicy.h"
+#include "jsonwriter.h"
+#include "logger.h"
+
+namespace luna
+{
+
+namespace
+{
+
+// any of them in the configuration picks the process model already
+const char *processModelFlags[] = {
+    "--single-process",
+    "--process-per-tab",
+    "--process-per-site",
+    "--site-per-process",
+};
+
+bool hasFlag(const QStringList &flags, const QString &name)
+{
+    Q_FOREACH(const QString &flag, flags) {
+        if (flag == name || flag.startsWith(name + "="))
+            return true;
+    }
+
+    return false;
+}
+
+bool hasProcessModelFlag(const QStringList &flags)
+{
+    for (unsigned int n = 0; n < sizeof(processModelFlags) / sizeof(processModelFlags[0]); n++) {
+        if (hasFlag(flags, processModelFlags[n]))
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace
+
+RendererProcessPolicy::RendererProcessPolicy() :
+    mSharedSystemRenderers(false),
+    mSharedRemoteRenderers(false),
+    mMaxRenderers(0)
+{
+}
+
+RendererProcessPolicy RendererProcessPolicy::fromEnvironment(int defaultMaxRenderers)
+{
+    RendererProcessPolicy policy;
+    policy.mMaxRenderers = defaultMaxRenderers;
+
+    QByteArray system = qgetenv("LUNA_WAM_SYSTEM_RENDERERS");
+    if (system == "shared")
+        policy.mSharedSystemRenderers = true;
+    else if (!system.isEmpty() && system != "dedicated")
+        qCWarning(lcManager) << "Ignoring invalid LUNA_WAM_SYSTEM_RENDERERS" << system;
+
+    QByteArray remote = qgetenv("LUNA_WAM_REMOTE_RENDERERS");
+    if (remote == "shared")
+        policy.mSharedRemoteRenderers = true;
+    else if (!remote.isEmpty() && remote != "dedicated")
+        qCWarning(lcManager) << "Ignoring invalid LUNA_WAM_REMOTE_RENDERERS" << remote;
+
+    QByteArray max = qgetenv("LUNA_WAM_MAX_RENDERERS");
+    if (!max.isEmpty()) {
+        bool ok = false;
+        int value = max.toInt(&ok);
+        if (ok && value >= 0)
+            policy.mMaxRenderers = value;
+        else
+            qCWarning(lcManager) << "Ignoring invalid LUNA_WAM_MAX_RENDERERS" << max;
+    }
+
+    return policy;
+}
+
+QStringList RendererProcessPolicy::chromiumFlags() const
+{
+    QStringList flags;
+
+    if (processPerSite())
+        flags << "--process-per-site";
+    if (mMaxRenderers > 0)
+        flags << QString("--renderer-process-limit=%1").arg(mMaxRenderers);
+
+    return flags;
+}
+
+void RendererProcessPolicy::apply(const QStringList &extraFlags)
+{
+    const QStringList configuredFlags = QString::fromUtf8(qgetenv("QTWEBENGINE_CHROMIUM_FLAGS")).split(' ', QString::SkipEmptyParts);
+    QStringList flags = configuredFlags;
+    mSkippedFlags.clear();
+
+    // the configuration was set up on purpose, e.g. --single-process for
+    // debugging, it wins over the policy
+    Q_FOREACH(const QString &flag, chromiumFlags()) {
+        bool configured;
+        if (flag.startsWith("--renderer-process-limit"))
+            configured = hasFlag(configuredFlags, "--renderer-process-limit") || hasFlag(configuredFlags, "--single-process");
+        else
+            configured = hasProcessModelFlag(configuredFlags);
+
+        if (configured)
+            mSkippedFlags << flag;
+        else
+            flags << flag;
+    }
+
+    if (!mSkippedFlags.isEmpty())
+        qCInfo(lcManager) << "Configured process model flags take precedence over" << mSkippedFlags;
+
+    Q_FOREACH(const QString &flag, extraFlags) {
+        if (!flags.contains(flag))
+            flags << flag;
+    }
+
+    setenv("QTWEBENGINE_CHROMIUM_FLAGS", flags.join(' ').toUtf8().constData(), 1);
+
+    qCInfo(lcManager) << "Renderer process policy: system" << (mSharedSystemRenderers ? "shared" : "dedicated")
+                      << "remote" << (mSharedRemoteRenderers ? "shared" : "dedicated")
+                      << "process per site" << processPerSite()
+                      << "max" << mMaxRenderers;
+}
+
+void RendererProcessPolicy::write(JsonWriter &writer) const
+{
+    writer.beginObject();
+    writer.member("systemRenderers", mSharedSystemRenderers ? "shared" : "dedicated");
+    writer.member("remoteRenderers", mSharedRemoteRenderers ? "shared" : "dedicated");
+    writer.member("processPerSite", processPerSite());
+    writer.member("maxRenderers", mMaxRenderers);
+
+    writer.key("chromiumFlags").beginArray();
+    Q_FOREACH(const QString &flag, chromiumFlags())
+        writer.value(flag);
+    writer.endArray();
+
+    writer.key("skippedFlags").beginArray();
+    Q_FOREACH(const QString &flag, mSkippedFlags)
+        writer.value(flag);
+    writer.endArray();
+
+    writer.endObject();
+}
+
+} // namespace luna
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef RENDERERPROCESSPOLICY_H
+#define RENDERERPROCESSPOLICY_H
+
+#include <QStringList>
+
+namespace luna
+{
+
+class JsonWriter;
+
+/*
+ * How the renderer processes are shared between the apps, by trust scope.
+ *
+ * Chromium only knows process model switches for the whole browser, so the
+ * policy is expressed through them. Shared renderers turn on
+ * --process-per-site, which puts all pages of one site into one process:
+ * the file:// apps, being one site, share a renderer, but so do remote apps
+ * of the same site, whatever the remote setting says. Without it Chromium's
+ * default model keeps every app in its own renderer until the renderer
+ * limit is reached, which is what the defaults keep.
+ *
+ * Process model flags the configuration passes in QTWEBENGINE_CHROMIUM_FLAGS
+ * take precedence, the policy skips its own flags that would conflict.
+ *
+ * Configured through the environment, i.e. /etc/luna-next/qtwebengine.conf:
+ *   LUNA_WAM_SYSTEM_RENDERERS  "dedicated" (default) or "shared"
+ *   LUNA_WAM_REMOTE_RENDERERS  "dedicated" (default) or "shared"
+ *   LUNA_WAM_MAX_RENDERERS     upper bound of renderer processes, 0 leaves
+ *                              it to Chromium, defaults to the bound of the
+ *                              device profile
+ */
+class RendererProcessPolicy
+{
+public:
+    RendererProcessPolicy();
+
+    static RendererProcessPolicy fromEnvironment(int defaultMaxRenderers = 0);
+
+    bool sharedSystemRenderers() const { return mSharedSystemRenderers; }
+    bool sharedRemoteRenderers() const { return mSharedRemoteRenderers; }
+    bool processPerSite() const { return mSharedSystemRenderers || mSharedRemoteRenderers; }
+    int maxRenderers() const { return mMaxRenderers; }
+
+    QStringList chromiumFlags() const;
+
+    // has to run before the first web engine profile or view is created,
+    // policy and extra flags are added unless the configuration has them
+    // or conflicting ones already
+    void apply(const QStringList &extraFlags = QStringList());
+
+    void write(JsonWriter &writer) const;
+
+private:
+    bool mSharedSystemRenderers;
+    bool mSharedRemoteRenderers;
+    int mMaxRenderers;
+    // policy flags left out for process model flags of the configuration
+    QStringList mSkippedFlags;
+};
+
+} // namespace luna
+
+#endif // RENDERERPROCESSPOLICY_H
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QStringList>
+
+#include <QtWebEngine/private/qquickwebengineview_p.h>
+#include <QtWebEngine/private/qquickwebengineloadrequest_p.h>
+#include <QtWebEngine/private/qquickwebenginenewviewrequest_p.h>
+
+#include "sharedrendererhost.h"
+#include "logger.h"
+
+#define OPEN_TIMEOUT_MSEC 5000
+#define MAX_HOST_RESTARTS 3
+
+namespace luna
+{
+
+namespace
+{
+
+// file:/// makes the host the same site as the apps' file:// pages
+const char *hostPage = "<!DOCTYPE html><html><head><title>shared renderer host</title></head></html>";
+
+} // namespace
+
+SharedRendererHost::SharedRendererHost(QQmlEngine *engine, QObject *parent) :
+    QObject(parent),
+    mEngine(engine),
+    mHostItem(0),
+    mHostView(0),
+    mReady(false),
+    mFailed(false),
+    mHostRestarts(0)
+{
+    mOpenTimer.setInterval(OPEN_TIMEOUT_MSEC);
+    connect(&mOpenTimer, SIGNAL(timeout()), this, SLOT(onOpenTimeout()));
+}
+
+SharedRendererHost::~SharedRendererHost()
+{
+    delete mHostItem;
+}
+
+bool SharedRendererHost::isEnabledFor(const QString &appId)
+{
+    static QStringList appIds = QString::fromUtf8(qgetenv("LUNA_WAM_SHARED_RENDERER_APPS"))
+                                    .split(',', QString::SkipEmptyParts);
+
+    return appIds.contains("*") || appIds.contains(appId);
+}
+
+void SharedRendererHost::createHostView()
+{
+    QQmlComponent component(mEngine, QUrl(QString("qrc:///qml/SharedRendererHost.qml")));
+    mHostItem = qobject_cast<QQuickItem*>(component.create());
+    mHostView = qobject_cast<QQuickWebEngineView*>(mHostItem);
+
+    if (!mHostView) {
+        qCWarning(lcWindow) << "Failed to create shared renderer host:" << component.errorString();
+        mFailed = true;
+        return;
+    }
+
+    connect(mHostView, SIGNAL(loadingChanged(QQuickWebEngineLoadRequest*)),
+            this, SLOT(onLoadingChanged(QQuickWebEngineLoadRequest*)));
+    connect(mHostView, SIGNAL(newViewRequested(QQuickWebEngineNewViewRequest*)),
+            this, SLOT(onNewViewRequested(QQuickWebEngineNewViewRequest*)));
+    // the signal declares its enum argument unqualified, which the string
+    // based connect can't match
+    connect(mHostView, &QQuickWebEngineView::renderProcessTerminated,
+            this, &SharedRendererHost::onHostTerminated);
+
+    mHostView->loadHtml(QString(hostPage), QUrl("file:///"));
+}
+
+void SharedRendererHost::destroyHostView()
+{
+    mReady = false;
+
+    if (mHostItem) {
+        disconnect(mHostView, 0, this, 0);
+        mHostItem->deleteLater();
+    }
+
+    mHostItem = 0;
+    mHostView = 0;
+}
+
+void SharedRendererHost::open(QQuickWebEngineView *view, const QUrl &url)
+{
+    PendingPage page;
+    page.view = view;
+    page.url = url;
+
+    if (!mHostItem && !mFailed)
+        createHostView();
+
+    // without a host the app simply gets a renderer of its own
+    if (mFailed) {
+        view->setUrl(url);
+        return;
+    }
+
+    if (mReady)
+        requestPage(page);
+    else
+        mPending.append(page);
+}
+
+void SharedRendererHost::requestPage(PendingPage page)
+{
+    if (!page.view)
+        return;
+
+    qCInfo(lcWindow) << "Opening" << page.url << "in the shared renderer host";
+
+    page.requested.start();
+    mOpening.append(page);
+    if (!mOpenTimer.isActive())
+        mOpenTimer.start();
+
+    // the array is just a convenient way to get the url quoted for JavaScript
+    QByteArray quotedUrl = QJsonDocument(QJsonArray() << page.url.toString()).toJson(QJsonDocument::Compact);
+    mHostView->runJavaScript(QString("window.open(%1[0], '_blank');").arg(QString::fromUtf8(quotedUrl)));
+}
+
+void SharedRendererHost::fallBack(QList<PendingPage> &pages)
+{
+    Q_FOREACH(const PendingPage &page, pages) {
+        if (page.view)
+            page.view->setUrl(page.url);
+    }
+    pages.clear();
+}
+
+void SharedRendererHost::onLoadingChanged(QQuickWebEngineLoadRequest *request)
+{
+    if (request->status() == QQuickWebEngineView::LoadStartedStatus) {
+        mReady = false;
+        return;
+    }
+
+    if (request->status() != QQuickWebEngineView::LoadSucceededStatus) {
+        qCWarning(lcWindow) << "Shared renderer host failed to load, hosted apps get their own renderer";
+
+        mFailed = true;
+        destroyHostView();
+        fallBack(mOpening);
+        fallBack(mPending);
+        return;
+    }
+
+    mReady = true;
+
+    QList<PendingPage> pending = mPending;
+    mPending.clear();
+    Q_FOREACH(const PendingPage &page, pending)
+        requestPage(page);
+}
+
+void SharedRendererHost::onNewViewRequested(QQuickWebEngineNewViewRequest *request)
+{
+    // a page opened for one app must never end up in another app's view,
+    // it would run with that app's bridge and bus identity
+    for (int n = 0; n < mOpening.size(); n++) {
+        if (!mOpening.at(n).url.matches(request->requestedUrl(), QUrl::NormalizePathSegments))
+            continue;
+
+        PendingPage page = mOpening.takeAt(n);
+
+        // the window went away in the meantime, the request is simply dropped
+        if (page.view)
+            request->openIn(page.view);
+        return;
+    }
+
+    qCWarning(lcWindow) << "Shared renderer host dropped a page nobody asked for:" << request->requestedUrl();
+}
+
+void SharedRendererHost::onHostTerminated()
+{
+    qCWarning(lcWindow) << "Shared renderer host terminated";
+
+    destroyHostView();
+
+    // pages not adopted yet are opened again from the new host, the ones
+    // adopted already restart their renderer on their own
+    mPending = mOpening + mPending;
+    mOpening.clear();
+    mOpenTimer.stop();
+
+    if (++mHostRestarts > MAX_HOST_RESTARTS) {
+        qCWarning(lcWindow) << "Giving up on the shared renderer host, hosted apps get their own renderer";
+        mFailed = true;
+        fallBack(mPending);
+        return;
+    }
+
+    createHostView();
+    if (mFailed)
+        fallBack(mPending);
+}
+
+void SharedRendererHost::onOpenTimeout()
+{
+    QList<PendingPage> expired;
+
+    for (int n = mOpening.size() - 1; n >= 0; n--) {
+        if (mOpening.at(n).requested.hasExpired(OPEN_TIMEOUT_MSEC))
+            expired.prepend(mOpening.takeAt(n));
+    }
+
+    if (!expired.isEmpty()) {
+        qCWarning(lcWindow) << "Shared renderer host didn't open" << expired.size() << "pages in time";
+        fallBack(expired);
+    }
+
+    if (mOpening.isEmpty())
+        mOpenTimer.stop();
+}
+
+} // namespace luna
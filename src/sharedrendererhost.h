@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SHAREDRENDERERHOST_H
+#define SHAREDRENDERERHOST_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QUrl>
+
+class QQmlEngine;
+class QQuickItem;
+class QQuickWebEngineView;
+class QQuickWebEngineLoadRequest;
+class QQuickWebEngineNewViewRequest;
+
+namespace luna
+{
+
+/*
+ * Hosts the pages of trusted headless apps in one shared renderer process.
+ *
+ * The host is an empty file:// page. Every hosted app's page is opened by
+ * the host through window.open() and adopted by the app's own web view, so
+ * Chromium keeps it in the host's browsing instance and, being the same
+ * site, in the host's renderer. Each page still has its own view, web
+ * channel and PalmSystem extension, only the process is shared.
+ *
+ * This is opt-in through LUNA_WAM_SHARED_RENDERER_APPS, a comma separated
+ * list of app ids or "*" for all headless apps with a file:// entry point.
+ * Hosted pages share the profile of the host, so apps with their own user
+ * agent are never hosted.
+ *
+ * A new view is only ever adopted by the app whose URL it was opened for,
+ * a page that isn't requested in time, or whose host went away, falls back
+ * to a renderer of its own.
+ */
+class SharedRendererHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SharedRendererHost(QQmlEngine *engine, QObject *parent = 0);
+    ~SharedRendererHost();
+
+    static bool isEnabledFor(const QString &appId);
+
+    void open(QQuickWebEngineView *view, const QUrl &url);
+
+private Q_SLOTS:
+    void onLoadingChanged(QQuickWebEngineLoadRequest *request);
+    void onNewViewRequested(QQuickWebEngineNewViewRequest *request);
+    void onHostTerminated();
+    void onOpenTimeout();
+
+private:
+    struct PendingPage
+    {
+        QPointer<QQuickWebEngineView> view;
+        QUrl url;
+        QElapsedTimer requested;
+    };
+
+    QQmlEngine *mEngine;
+    QQuickItem *mHostItem;
+    QQuickWebEngineView *mHostView;
+    bool mReady;
+    // set once the host can't be used anymore, apps get their own renderer
+    bool mFailed;
+    int mHostRestarts;
+    // waiting for the host page to load
+    QList<PendingPage> mPending;
+    // window.open() issued, waiting for the view to be requested
+    QList<PendingPage> mOpening;
+    QTimer mOpenTimer;
+
+    void createHostView();
+    void destroyHostView();
+    void requestPage(PendingPage page);
+    void fallBack(QList<PendingPage> &pages);
+};
+
+} // namespace luna
+
+#endif // SHAREDRENDERERHOST_H
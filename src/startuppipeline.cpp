@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <QDebug>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTimer>
+
+#include "startuppipeline.h"
+#include "logger.h"
+
+namespace luna
+{
+
+namespace
+{
+
+class StageRunnable : public QRunnable
+{
+public:
+    StageRunnable(StartupPipeline *pipeline, const QString &name, std::function<void()> stage) :
+        mPipeline(pipeline),
+        mName(name),
+        mStage(stage)
+    {
+    }
+
+    void run()
+    {
+        mStage();
+
+        // report back on the GUI thread
+        QMetaObject::invokeMethod(mPipeline, "onStageFinished", Qt::QueuedConnection,
+                                  Q_ARG(QString, mName));
+    }
+
+private:
+    StartupPipeline *mPipeline;
+    QString mName;
+    std::function<void()> mStage;
+};
+
+} // namespace
+
+StartupPipeline::StartupPipeline(QObject *parent) :
+    QObject(parent),
+    mStarted(false),
+    mFinished(false)
+{
+    mTimer.start();
+}
+
+void StartupPipeline::run(const QString &name, std::function<void()> stage)
+{
+    beginStage(name);
+    stage();
+    finishStage(name);
+}
+
+void StartupPipeline::runConcurrently(const QString &name, std::function<void()> stage)
+{
+    beginStage(name);
+    QThreadPool::globalInstance()->start(new StageRunnable(this, name, stage));
+}
+
+void StartupPipeline::beginStage(const QString &name, int timeoutMsec)
+{
+    mRunningStages.insert(name, mTimer.elapsed());
+
+    if (timeoutMsec > 0) {
+        QTimer *timer = new QTimer(this);
+        timer->setObjectName(name);
+        timer->setSingleShot(true);
+        connect(timer, SIGNAL(timeout()), this, SLOT(onStageTimeout()));
+        timer->start(timeoutMsec);
+    }
+}
+
+void StartupPipeline::finishStage(const QString &name)
+{
+    if (!mRunningStages.contains(name))
+        return;
+
+    qint64 started = mRunningStages.take(name);
+    qCInfo(lcManager, "Startup stage %s took %lld ms (finished after %lld ms)", name.toUtf8().constData(),
+                      mTimer.elapsed() - started, mTimer.elapsed());
+
+    checkFinished();
+}
+
+void StartupPipeline::onStageFinished(const QString &name)
+{
+    finishStage(name);
+}
+
+void StartupPipeline::onStageTimeout()
+{
+    QTimer *timer = static_cast<QTimer*>(sender());
+    QString name = timer->objectName();
+    timer->deleteLater();
+
+    if (!mRunningStages.contains(name))
+        return;
+
+    qCWarning(lcManager, "Startup stage %s didn't finish in time, not waiting for it", name.toUtf8().constData());
+    mRunningStages.remove(name);
+
+    checkFinished();
+}
+
+void StartupPipeline::start()
+{
+    mStarted = true;
+
+    // finish from within the event loop even if all stages are done already
+    QTimer::singleShot(0, this, SLOT(checkFinished()));
+}
+
+void StartupPipeline::checkFinished()
+{
+    if (!mStarted || mFinished || !mRunningStages.isEmpty())
+        return;
+
+    mFinished = true;
+
+    qCInfo(lcManager, "Startup finished after %lld ms", mTimer.elapsed());
+
+    emit finished();
+}
+
+} // namespace luna
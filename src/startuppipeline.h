@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef STARTUPPIPELINE_H
+#define STARTUPPIPELINE_H
+
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+namespace luna
+{
+
+/*
+ * Runs the initialization steps of the manager and logs how long each of
+ * them took.
+ *
+ * Steps touching GUI thread objects run right away, independent ones run on
+ * the thread pool or complete through a bus reply. finished() is emitted from
+ * the event loop once every stage is done.
+ */
+class StartupPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StartupPipeline(QObject *parent = 0);
+
+    void run(const QString &name, std::function<void()> stage);
+    // The stage runs on the thread pool. Anything it creates has to be safe
+    // to create concurrently with GUI thread users, and QObjects it leaves
+    // behind have to be moved to the GUI thread before it returns.
+    void runConcurrently(const QString &name, std::function<void()> stage);
+
+    // The stage ends with finishStage(), or when the timeout expired
+    void beginStage(const QString &name, int timeoutMsec = 0);
+    void finishStage(const QString &name);
+
+    void start();
+
+Q_SIGNALS:
+    void finished();
+
+private Q_SLOTS:
+    void onStageFinished(const QString &name);
+    void onStageTimeout();
+    void checkFinished();
+
+private:
+    QElapsedTimer mTimer;
+    // start time of the running stages, relative to mTimer
+    QHash<QString, qint64> mRunningStages;
+    bool mStarted;
+    bool mFinished;
+};
+
+} // namespace luna
+
+#endif // STARTUPPIPELINE_H
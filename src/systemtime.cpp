@@ -19,29 +19,35 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 
+#include <glib.h>
 #include <time.h>
 
 #include <luna-service2++/message.hpp>
 
 #include "systemtime.h"
+#include "logger.h"
 
 namespace luna
 {
 
-SystemTime* SystemTime::instance()
+void* SystemTime::createInstance(void*)
 {
-    static SystemTime* instance = 0;
+    return new SystemTime();
+}
 
-    if (!instance)
-        instance = new SystemTime();
+// The startup registers on a worker thread while apps may already ask for it
+SystemTime* SystemTime::instance()
+{
+    static GOnce once = G_ONCE_INIT;
+    g_once(&once, createInstance, NULL);
 
-    return instance;
+    return static_cast<SystemTime*>(once.retval);
 }
 
 SystemTime::SystemTime() :
     mLunaPrivHandle(NULL, false)
 {
-    qDebug() << __PRETTY_FUNCTION__ << "Registering for system time changes ...";
+    qCDebug(lcManager) << __PRETTY_FUNCTION__ << "Registering for system time changes ...";
 
     mLunaPrivHandle.attachToLoop(g_main_context_default());
 
@@ -90,7 +96,7 @@ void SystemTime::updateFromService(LSMessage *message)
             setenv("TZ", mTimezone.toUtf8().constData(), 1);
             tzset();
 
-            qDebug() << __PRETTY_FUNCTION__ << "timezone has changed to" << mTimezone;
+            qCDebug(lcManager) << __PRETTY_FUNCTION__ << "timezone has changed to" << mTimezone;
         }
     }
 }
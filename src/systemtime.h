@@ -36,6 +36,7 @@ public:
 
 private:
     SystemTime();
+    static void* createInstance(void*);
 
     void updateFromService(LSMessage *message);
     static bool updateCallback(LSHandle *handle, LSMessage *message, void *context);
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "jsonwriter.h"
+#include "tracing.h"
+
+namespace luna
+{
+
+std::atomic<bool> Tracer::sEnabled(false);
+
+namespace
+{
+
+__thread void *currentThreadBuffer = 0;
+
+qint64 monotonicMicroseconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (qint64) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+} // namespace
+
+Tracer* Tracer::instance()
+{
+    static Tracer* instance = 0;
+
+    if (!instance)
+        instance = new Tracer();
+
+    return instance;
+}
+
+quint64 Tracer::nextFlowId()
+{
+    static std::atomic<quint64> id(0);
+    return ++id;
+}
+
+Tracer::ThreadBuffer *Tracer::threadBuffer()
+{
+    if (currentThreadBuffer)
+        return static_cast<ThreadBuffer*>(currentThreadBuffer);
+
+    // buffers are kept for the lifetime of the process, threads come and go
+    // rarely enough in here for that not to matter
+    ThreadBuffer *buffer = new ThreadBuffer;
+    buffer->tid = syscall(SYS_gettid);
+    buffer->count = 0;
+
+    std::lock_guard<std::mutex> lock(mBuffersMutex);
+    mBuffers.append(buffer);
+    currentThreadBuffer = buffer;
+
+    return buffer;
+}
+
+void Tracer::start()
+{
+    std::lock_guard<std::mutex> lock(mBuffersMutex);
+
+    Q_FOREACH(ThreadBuffer *buffer, mBuffers)
+        buffer->count.store(0, std::memory_order_relaxed);
+
+    sEnabled = true;
+}
+
+void Tracer::record(char phase, const char *category, const char *name, quint64 id, qint64 value)
+{
+    ThreadBuffer *buffer = threadBuffer();
+
+    quint64 index = buffer->count.load(std::memory_order_relaxed);
+    Event &event = buffer->events[index % EventsPerThread];
+    event.phase = phase;
+    event.category = category;
+    event.name = name;
+    event.timestamp = monotonicMicroseconds();
+    event.id = id;
+    event.value = value;
+
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+QByteArray Tracer::stop(int *eventCount)
+{
+    sEnabled = false;
+
+    int pid = getpid();
+    int events = 0;
+
+    JsonWriter trace;
+    trace.beginObject();
+    trace.member("displayTimeUnit", "ms");
+    trace.key("traceEvents").beginArray();
+
+    std::lock_guard<std::mutex> lock(mBuffersMutex);
+
+    Q_FOREACH(ThreadBuffer *buffer, mBuffers) {
+        quint64 count = buffer->count.load(std::memory_order_acquire);
+        quint64 first = count > EventsPerThread ? count - EventsPerThread : 0;
+
+        for (quint64 n = first; n < count; n++) {
+            const Event &event = buffer->events[n % EventsPerThread];
+
+            trace.beginObject();
+            trace.member("name", event.name);
+            trace.member("cat", event.category);
+            trace.member("ph", QString(QChar(event.phase)));
+            trace.member("ts", event.timestamp);
+            trace.member("pid", pid);
+            trace.member("tid", buffer->tid);
+            if (event.phase == 'C') {
+                trace.key("args").beginObject();
+                trace.member("value", event.value);
+                trace.endObject();
+            }
+            else if (event.phase == 's' || event.phase == 't') {
+                trace.member("id", (qint64) event.id);
+                // bind the flow to the enclosing slice
+                trace.member("bp", "e");
+            }
+            trace.endObject();
+
+            events++;
+        }
+    }
+
+    trace.endArray();
+    trace.endObject();
+
+    if (eventCount)
+        *eventCount = events;
+
+    return QByteArray(trace.constData(), trace.size());
+}
+
+} // namespace luna
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 webOS Ports
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <atomic>
+#include <mutex>
+
+#include <QByteArray>
+#include <QList>
+#include <QtGlobal>
+
+namespace luna
+{
+
+/*
+ * Trace events in the Chrome trace format.
+ *
+ * Every thread records into its own ring, so recording takes no lock and
+ * costs one atomic load while tracing is off. The timestamps come from the
+ * monotonic clock like Chromium's, a dump can be loaded together with a
+ * Chromium trace into chrome://tracing or Perfetto.
+ *
+ * Names and categories have to be string literals, only their pointers are
+ * stored.
+ */
+class Tracer
+{
+public:
+    static Tracer* instance();
+
+    static bool isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+    void start();
+    QByteArray stop(int *eventCount = 0);
+
+    void record(char phase, const char *category, const char *name, quint64 id = 0, qint64 value = 0);
+
+    static quint64 nextFlowId();
+
+private:
+    Tracer() {}
+
+    struct Event
+    {
+        char phase;
+        const char *category;
+        const char *name;
+        qint64 timestamp;
+        quint64 id;
+        qint64 value;
+    };
+
+    enum { EventsPerThread = 8192 };
+
+    struct ThreadBuffer
+    {
+        int tid;
+        Event events[EventsPerThread];
+        std::atomic<quint64> count;
+    };
+
+    static std::atomic<bool> sEnabled;
+
+    std::mutex mBuffersMutex;
+    QList<ThreadBuffer*> mBuffers;
+
+    ThreadBuffer *threadBuffer();
+};
+
+class TraceScope
+{
+public:
+    TraceScope(const char *category, const char *name) :
+        mCategory(category),
+        mName(name),
+        mEnabled(Tracer::isEnabled())
+    {
+        if (mEnabled)
+            Tracer::instance()->record('B', mCategory, mName);
+    }
+
+    ~TraceScope()
+    {
+        if (mEnabled)
+            Tracer::instance()->record('E', mCategory, mName);
+    }
+
+private:
+    const char *mCategory;
+    const char *mName;
+    bool mEnabled;
+};
+
+} // namespace luna
+
+#define TRACE_CONCAT_(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#define TRACE_SCOPE(category, name) \
+    luna::TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name)
+
+#define TRACE_COUNTER(category, name, value) \
+    do { if (luna::Tracer::isEnabled()) luna::Tracer::instance()->record('C', category, name, 0, value); } while (0)
+
+#define TRACE_FLOW_BEGIN(category, name, id) \
+    do { if (luna::Tracer::isEnabled()) luna::Tracer::instance()->record('s', category, name, id); } while (0)
+
+#define TRACE_FLOW_STEP(category, name, id) \
+    do { if (luna::Tracer::isEnabled()) luna::Tracer::instance()->record('t', category, name, id); } while (0)
+
+#endif // TRACING_H
@@ -23,5 +23,5 @@ QString jsonObjectToString(const QJsonObject &object)
 {
     QJsonDocument doc;
     doc.setObject(object);
-    return QString(doc.toJson());
+    return QString(doc.toJson(QJsonDocument::Compact));
 }
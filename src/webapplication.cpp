@@ -29,6 +29,7 @@
 #include "applicationdescription.h"
 #include "webapplication.h"
 #include "webapplicationwindow.h"
+#include "logger.h"
 
 #include <Settings.h>
 
@@ -121,9 +122,10 @@ WebApplication::WebApplication(WebAppManager *launcher, const QUrl& url, const Q
     mMainWindowType(windowType),
     mLaunchedAtBoot(false),
     mPrivileged(false),
+    mStageReadyPosted(false),
     mActivity(mIdentifier, desc.getId(), processId)
 {
-    qDebug() << __PRETTY_FUNCTION__ << this;
+    qCDebug(lcApplication) << __PRETTY_FUNCTION__ << this;
 
     if (url.toString(QUrl::None).startsWith("file:///usr/palm/applications/com.palm.systemui"))
         mIdentifier = QString("com.palm.systemui-%1").arg(mProcessId);
@@ -141,7 +143,7 @@ WebApplication::WebApplication(WebAppManager *launcher, const QUrl& url, const Q
 
 WebApplication::~WebApplication()
 {
-    qDebug() << __PRETTY_FUNCTION__ << this;
+    qCDebug(lcApplication) << __PRETTY_FUNCTION__ << this;
 
     Q_FOREACH(WebApplicationWindow *window, mAppWindows) {
         mAppWindows.removeAll(window);
@@ -171,7 +173,7 @@ void WebApplication::changeActivityFocus(bool focus)
 
 void WebApplication::relaunch(const QString &parameters)
 {
-    qDebug() << __PRETTY_FUNCTION__ << "Relaunching application" << mDescription.getId() << "with parameters" << parameters;
+    qCDebug(lcApplication) << __PRETTY_FUNCTION__ << "Relaunching application" << mDescription.getId() << "with parameters" << parameters;
 
     mParameters = parameters;
     emit parametersChanged(true);
@@ -189,15 +191,29 @@ void WebApplication::createMainWindow()
             QSize(Settings::LunaSettings()->displayWidth, Settings::LunaSettings()->displayHeight),
             headless());
 
+    connect(mMainWindow, SIGNAL(readyChanged()), this, SLOT(onMainWindowReadyChanged()));
+    // a remote page is ready while the window is still being constructed,
+    // catch up once our own creator had the chance to connect to us
+    QMetaObject::invokeMethod(this, "onMainWindowReadyChanged", Qt::QueuedConnection);
+
     mAppWindows.append(mMainWindow);
 }
 
+void WebApplication::onMainWindowReadyChanged()
+{
+    // the stage can get ready through several paths, the app only once
+    if (!mStageReadyPosted && mMainWindow && mMainWindow->ready()) {
+        mStageReadyPosted = true;
+        emit stageReady();
+    }
+}
+
 void WebApplication::createWindow(QQuickWebEngineNewViewRequest *request)
 {
     int width = Settings::LunaSettings()->displayWidth;
     int height = Settings::LunaSettings()->displayHeight;
 
-    qDebug() << __PRETTY_FUNCTION__ << "Creating new window for url" << request->url();
+    qCDebug(lcApplication) << __PRETTY_FUNCTION__ << "Creating new window for url" << request->url();
 
     const QStringList &additionalFeatures = request->additionalFeatures();
     // The list could be something like a,b={titi},attributes={"window":"card","height":"150"}
@@ -226,19 +242,19 @@ void WebApplication::createWindow(QQuickWebEngineNewViewRequest *request)
 
         windowMetrics = attributesJsonDocument.object().value("metrics").toString();
         
-        qDebug() << __PRETTY_FUNCTION__ << "windowMetric metrics value: " << windowMetrics;
+        qCDebug(lcApplication) << __PRETTY_FUNCTION__ << "windowMetric metrics value: " << windowMetrics;
     }
 
     height = request->requestedGeometry().height();
     if (windowMetrics == "units") {
-        qDebug() << __PRETTY_FUNCTION__ << "windowMetrics == \"units\" Settings::LunaSettings()->gridUnit: " << Settings::LunaSettings()->gridUnit;
+        qCDebug(lcApplication) << __PRETTY_FUNCTION__ << "windowMetrics == \"units\" Settings::LunaSettings()->gridUnit: " << Settings::LunaSettings()->gridUnit;
         float gridUnit = Settings::LunaSettings()->gridUnit;
         height = static_cast<int>(qRound(height * gridUnit));
     }
     else {
         height *= Settings::LunaSettings()->layoutScale;
     }
-    qDebug() << __PRETTY_FUNCTION__ << "height: " << height;
+    qCDebug(lcApplication) << __PRETTY_FUNCTION__ << "height: " << height;
 
     QVariantMap lWindowAttributesMap;
     if( !attributesJsonDocument.isEmpty() )
@@ -251,7 +267,7 @@ void WebApplication::createWindow(QQuickWebEngineNewViewRequest *request)
         launchedFromWindowId = mMainWindow->windowId();
     }
 
-    qDebug() << Q_FUNC_INFO << "Setting parent window id" << launchedFromWindowId << "for new window";
+    qCDebug(lcApplication) << Q_FUNC_INFO << "Setting parent window id" << launchedFromWindowId << "for new window";
     WebApplicationWindow *window = new WebApplicationWindow(this, request->url(),
                                                             windowType, QSize(width, height),
                                                             false, lWindowAttributesMap,
@@ -266,7 +282,7 @@ void WebApplication::closeWindow(WebApplicationWindow *window)
 {
     // if the window is marked as keep alive we don't close it
     if (window->keepAlive()) {
-        qDebug() << "Not closing window cause it was configured to be kept alive";
+        qCDebug(lcApplication) << "Not closing window cause it was configured to be kept alive";
         return;
     }
 
@@ -284,7 +300,7 @@ void WebApplication::closeWindow(WebApplicationWindow *window)
         }
         // if the last remaining window is an headless window, close it too
         else if (mAppWindows.count() == 1 && mAppWindows.at(0)->headless() && !mLaunchedAtBoot) {
-            qDebug() << "All visible windows of app" << id()
+            qCDebug(lcApplication) << "All visible windows of app" << id()
                      << "were closed so closing the main window too";
 
             closeWindow(mAppWindows.at(0));
@@ -297,6 +313,16 @@ void WebApplication::kill()
     emit closed();
 }
 
+bool WebApplication::hasPersistentWindows() const
+{
+    Q_FOREACH(WebApplicationWindow *window, mAppWindows) {
+        if (window->keepAlive() || window->windowType() == "dashboard")
+            return true;
+    }
+
+    return false;
+}
+
 void WebApplication::clearMemoryCaches()
 {
     mMainWindow->clearMemoryCaches();
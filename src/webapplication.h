@@ -89,6 +89,8 @@ public:
 
     void kill();
 
+    bool hasPersistentWindows() const;
+
     void clearMemoryCaches();
 
 public Q_SLOTS:
@@ -97,6 +99,10 @@ public Q_SLOTS:
 Q_SIGNALS:
     void closed();
     void parametersChanged(bool needRelaunch = false);
+    void stageReady();
+
+private Q_SLOTS:
+    void onMainWindowReadyChanged();
 
 private:
     void processParameters();
@@ -113,6 +119,7 @@ private:
     QList<WebApplicationWindow*> mAppWindows;
     bool mLaunchedAtBoot;
     bool mPrivileged;
+    bool mStageReadyPosted;
     Activity mActivity;
 };
 
@@ -18,6 +18,7 @@
 #include <QDebug>
 
 #include "webapplicationplugin.h"
+#include "logger.h"
 
 namespace luna
 {
@@ -32,13 +33,13 @@ bool WebApplicationPlugin::load()
 {
     mLoader.setFileName(mPath.filePath());
     if (Q_UNLIKELY(!mLoader.load())) {
-        qWarning() << "Failed to load application plugin: " << mLoader.errorString();
+        qCWarning(lcApplication) << "Failed to load application plugin: " << mLoader.errorString();
         return false;
     }
 
     mInstance = qobject_cast<ApplicationPlugin*>(mLoader.instance());
     if (Q_UNLIKELY(mInstance == 0)) {
-        qWarning() << mPath.filePath() << "doesn't implement application plugin interface";
+        qCWarning(lcApplication) << mPath.filePath() << "doesn't implement application plugin interface";
         return false;
     }
 
@@ -26,6 +26,7 @@
 #include <luna-service2++/call.hpp>
 
 #include "webapplicationredirecthandler.h"
+#include "logger.h"
 
 namespace luna
 {
@@ -44,7 +45,7 @@ WebApplicationRedirectHandler::~WebApplicationRedirectHandler()
 void WebApplicationRedirectHandler::requestStarted(QWebEngineUrlRequestJob *request)
 {
     QString targetURI = request->requestUrl().toString();
-    qDebug() << __PRETTY_FUNCTION__ << "requestStarted for " << targetURI;
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "requestStarted for " << targetURI;
 
     LS::Call call = mLunaPubHandle.callOneReply("luna://com.palm.applicationManager/open",
                                                 QString("{\"target\":\"%1\"}").arg(targetURI).toUtf8().constData(),
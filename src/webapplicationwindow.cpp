@@ -20,6 +20,7 @@
 #include <QQmlContext>
 #include <QQmlComponent>
 #include <QtGui/QGuiApplication>
+#include <QtGui/QPlatformSurfaceEvent>
 #include <QtGui/qpa/qplatformnativeinterface.h>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -46,10 +47,40 @@
 #include "extensions/wifimanager.h"
 #include "extensions/bluetoothmanager.h"
 #include "extensions/inappbrowserextension.h"
+#include "logger.h"
+#include "sharedrendererhost.h"
+#include "tracing.h"
 
 namespace luna
 {
 
+namespace
+{
+
+// Headless windows have no scene of their own to render, so they all share
+// one engine and only get a context each to hold their properties.
+QQmlEngine *headlessEngine()
+{
+    static QQmlEngine *engine = 0;
+
+    if (!engine)
+        engine = new QQmlEngine;
+
+    return engine;
+}
+
+SharedRendererHost *sharedRendererHost()
+{
+    static SharedRendererHost *host = 0;
+
+    if (!host)
+        host = new SharedRendererHost(headlessEngine());
+
+    return host;
+}
+
+} // namespace
+
 WebApplicationWindow::WebApplicationWindow(WebApplication *application, const QUrl& url,
                                            const QString& windowType, const QSize& size,
                                            bool headless, const QVariantMap &windowAttributesMap,
@@ -74,7 +105,7 @@ WebApplicationWindow::WebApplicationWindow(WebApplication *application, const QU
     mLoadingAnimationDisabled(false),
     mIsActive(false)
 {
-    qDebug() << __PRETTY_FUNCTION__ << this << size;
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << this << size;
 
     connect(&mStageReadyTimer, SIGNAL(timeout()), this, SLOT(onStageReadyTimeout()));
     mStageReadyTimer.setSingleShot(true);
@@ -82,26 +113,42 @@ WebApplicationWindow::WebApplicationWindow(WebApplication *application, const QU
     assignCorrectTrustScope();
 
     createAndSetup(windowAttributesMap);
+
+    // the compositor assigns the id of a real window later on, headless
+    // ones never get one
+    if (mHeadless)
+        notifyWindowCreated();
 }
 
 WebApplicationWindow::~WebApplicationWindow()
 {
-    qDebug() << __PRETTY_FUNCTION__ << this;
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << this;
+
+    notifyAppEvent("windowDestroyed");
 
     Q_FOREACH(BaseExtension *extension, mExtensions.values())
         delete extension;
 
     mExtensions.clear();
 
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    if (pWebAppManager && pWebAppManager->getService())
+        pWebAppManager->getService()->resourceMonitor().forgetView(this);
+
+    // the shared engine stays, only our own container goes
     if (mHeadless)
-        delete mEngine;
+        delete mRootItem;
 
-    if (mWindow)
+    if (mWindow) {
+        ((WebAppManager*)qGuiApp)->unregisterWindow(this);
         delete mWindow;
+    }
 }
 
 void WebApplicationWindow::destroy()
 {
+    // the platform window goes away, showing the window again creates and
+    // registers a new one
     if (mWindow)
         mWindow->destroy();
 }
@@ -128,32 +175,27 @@ QVariant WebApplicationWindow::getWindowProperty(const QString &name)
 
 void WebApplicationWindow::updateWindowProperty(const QString &name)
 {
-    qDebug() << Q_FUNC_INFO << "Window property" << name << "was updated";
+    qCDebug(lcWindow) << Q_FUNC_INFO << "Window property" << name << "was updated";
 
-    if (name == "_LUNE_WINDOW_ID")
+    if (name == "_LUNE_WINDOW_ID") {
+        bool firstId = mWindowId == 0;
         mWindowId = getWindowProperty("_LUNE_WINDOW_ID").toInt();
+
+        // a recreated platform window gets a new id but is the same window
+        if (firstId && mWindowId != 0)
+            notifyWindowCreated();
+    }
     else if (name == "_LUNE_WINDOW_PARENT_ID")
         mParentWindowId = getWindowProperty("_LUNE_WINDOW_PARENT_ID").toInt();
 }
 
-void WebApplicationWindow::onWindowPropertyChanged(QPlatformWindow *window, const QString &name)
-{
-    if (!mWindow)
-        return;
-
-    if (window != mWindow->handle())
-        return;
-
-    updateWindowProperty(name);
-}
-
-void WebApplicationWindow::configureQmlEngine()
+void WebApplicationWindow::configureQmlEngine(QQmlContext *context)
 {
     if (!mEngine)
         return;
 
-    mEngine->rootContext()->setContextProperty("webApp", mApplication);
-    mEngine->rootContext()->setContextProperty("webAppWindow", this);
+    context->setContextProperty("webApp", mApplication);
+    context->setContextProperty("webAppWindow", this);
     if( QDir().mkpath("/media/internal/.app-storage") )
         mEngine->setOfflineStoragePath("/media/internal/.app-storage");
 
@@ -163,7 +205,7 @@ QQuickWebEngineScript *WebApplicationWindow::getScriptFromUrl(const QString &isc
 {
     QFile f(iUrl);
     if (!f.open(QIODevice::ReadOnly)) {
-        qWarning() << "Can't open user script " << iUrl;
+        qCWarning(lcWindow) << "Can't open user script " << iUrl;
         return 0;
     }
 
@@ -180,6 +222,8 @@ QQuickWebEngineScript *WebApplicationWindow::getScriptFromUrl(const QString &isc
 
 void WebApplicationWindow::createAndSetup(const QVariantMap &windowAttributesMap)
 {
+    TRACE_SCOPE("window", "WebApplicationWindow::createAndSetup");
+
     if (mTrustScope == TrustScopeSystem) {
         mUserScripts.append(getScriptFromUrl("webosAPI", QString("://qml/webos-api.js"), QQuickWebEngineScript::DocumentCreation, false));
         createDefaultExtensions();
@@ -189,13 +233,16 @@ void WebApplicationWindow::createAndSetup(const QVariantMap &windowAttributesMap
         mLoadingAnimationDisabled = true;
 
     if (mHeadless) {
-        qDebug() << __PRETTY_FUNCTION__ << "Creating application container for headless ...";
+        qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "Creating application container for headless ...";
 
-        mEngine = new QQmlEngine;
-        configureQmlEngine();
+        mEngine = headlessEngine();
+        QQmlContext *context = new QQmlContext(mEngine->rootContext(), this);
+        configureQmlEngine(context);
 
-        QQmlComponent component(mEngine, QUrl(QString("qrc:///qml/ApplicationContainer.qml")));
-        mRootItem = qobject_cast<QQuickItem*>(component.create());
+        QQmlComponent component(mEngine, QUrl(QString("qrc:///qml/HeadlessContainer.qml")));
+        mRootItem = qobject_cast<QQuickItem*>(component.create(context));
+        if (!mRootItem)
+            qCWarning(lcWindow) << "Failed to create headless container:" << component.errorString();
     }
     else {
         mWindow = new QQuickView;
@@ -203,10 +250,10 @@ void WebApplicationWindow::createAndSetup(const QVariantMap &windowAttributesMap
 
 
         mEngine = mWindow->engine();
-        configureQmlEngine();
+        configureQmlEngine(mEngine->rootContext());
 
         connect(mWindow, &QObject::destroyed,  [=](QObject *obj) {
-            qDebug() << "Window destroyed";
+            qCDebug(lcWindow) << "Window destroyed";
         });
 
         mWindow->setColor(Qt::transparent);
@@ -220,26 +267,12 @@ void WebApplicationWindow::createAndSetup(const QVariantMap &windowAttributesMap
         mWindow->setFormat(surfaceFormat);
 
         // make sure the platform window gets created to be able to set it's
-        // window properties
+        // window properties, see setupPlatformWindow()
+        mWindowAttributes = windowAttributesMap;
         mWindow->create();
 
-        // set different information bits for our window
-        foreach(QString attrKey, windowAttributesMap.keys()) {
-            setWindowProperty("LuneOS_"+attrKey,windowAttributesMap.value(attrKey));
-        }
-
-        setWindowProperty(QString("_LUNE_WINDOW_TYPE"), QVariant(mWindowType));
-        setWindowProperty(QString("_LUNE_WINDOW_PARENT_ID"), QVariant(mParentWindowId));
-        setWindowProperty(QString("_LUNE_WINDOW_LOADING_ANIMATION_DISABLED"), QVariant(mApplication->loadingAnimationDisabled()));
-        setWindowProperty(QString("_LUNE_APP_ICON"), QVariant(mApplication->icon()));
-        setWindowProperty(QString("_LUNE_APP_ID"), QVariant(mApplication->id()));
-        
         connect(mWindow, SIGNAL(visibleChanged(bool)), this, SLOT(onVisibleChanged(bool)));
 
-        QPlatformNativeInterface *nativeInterface = QGuiApplication::platformNativeInterface();
-        connect(nativeInterface, SIGNAL(windowPropertyChanged(QPlatformWindow*, const QString&)),
-                this, SLOT(onWindowPropertyChanged(QPlatformWindow*, const QString&)));
-
         mWindow->setSource(QUrl(QString("qrc:///qml/ApplicationContainer.qml")));
 
         mRootItem = mWindow->rootObject();
@@ -248,6 +281,24 @@ void WebApplicationWindow::createAndSetup(const QVariantMap &windowAttributesMap
     }
 }
 
+void WebApplicationWindow::setupPlatformWindow()
+{
+    // set different information bits for our window
+    foreach(QString attrKey, mWindowAttributes.keys()) {
+        setWindowProperty("LuneOS_"+attrKey,mWindowAttributes.value(attrKey));
+    }
+
+    setWindowProperty(QString("_LUNE_WINDOW_TYPE"), QVariant(mWindowType));
+    setWindowProperty(QString("_LUNE_WINDOW_PARENT_ID"), QVariant(mParentWindowId));
+    setWindowProperty(QString("_LUNE_WINDOW_LOADING_ANIMATION_DISABLED"), QVariant(mApplication->loadingAnimationDisabled()));
+    setWindowProperty(QString("_LUNE_APP_ICON"), QVariant(mApplication->icon()));
+    setWindowProperty(QString("_LUNE_APP_ID"), QVariant(mApplication->id()));
+
+    // the manager hands us the property changes of our window only
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    pWebAppManager->registerWindow(mWindow->handle(), this);
+}
+
 void WebApplicationWindow::installUrlSchemeHandlers(QQuickWebEngineProfile *webViewProfile)
 {
     if(!webViewProfile) return;
@@ -255,13 +306,21 @@ void WebApplicationWindow::installUrlSchemeHandlers(QQuickWebEngineProfile *webV
     WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
     if(!pWebAppManager || !pWebAppManager->getService()) return;
 
-    LS::Handle &serviceHandle(pWebAppManager->getService()->getServiceHandle());
-    LS::Call callGetMimeTable = serviceHandle.callOneReply("luna://com.palm.applicationManager/dumpMimeTable",
-                                                           "{}",
-                                                           mApplication->identifier().toUtf8().constData());
-    LS::Message message(callGetMimeTable.get(1000));
-    QJsonObject response = QJsonDocument::fromJson(message.getPayload()).object();
-    QJsonArray redirectsArray = response.value("redirects").toArray();
+    QJsonArray redirectsArray;
+
+    // the table is prefetched at startup, only ask on our own if that failed
+    if (pWebAppManager->hasMimeTable()) {
+        redirectsArray = pWebAppManager->mimeRedirects();
+    }
+    else {
+        LS::Handle &serviceHandle(pWebAppManager->getService()->getServiceHandle());
+        LS::Call callGetMimeTable = serviceHandle.callOneReply("luna://com.palm.applicationManager/dumpMimeTable",
+                                                               "{}",
+                                                               mApplication->identifier().toUtf8().constData());
+        LS::Message message(callGetMimeTable.get(1000));
+        QJsonObject response = QJsonDocument::fromJson(message.getPayload()).object();
+        redirectsArray = response.value("redirects").toArray();
+    }
 
     QJsonArray::const_iterator i;
     for (i = redirectsArray.constBegin(); i != redirectsArray.constEnd(); ++i) {
@@ -271,7 +330,7 @@ void WebApplicationWindow::installUrlSchemeHandlers(QQuickWebEngineProfile *webV
         if(redirectUrlPattern.startsWith("^") && redirectUrlPattern.endsWith(":") && !redirectUrlPattern.endsWith("?:")) {
             // extract the scheme from the url pattern
             QString lSchemeFromUri = redirectUrlPattern.mid(1, redirectUrlPattern.length()-2);
-            qDebug() << __PRETTY_FUNCTION__ << "installing scheme handler for " << lSchemeFromUri;
+            qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "installing scheme handler for " << lSchemeFromUri;
             webViewProfile->installUrlSchemeHandler(lSchemeFromUri.toLatin1(), &mRedirectHandler);
         }
     }
@@ -279,12 +338,14 @@ void WebApplicationWindow::installUrlSchemeHandlers(QQuickWebEngineProfile *webV
 
 void WebApplicationWindow::configureWebView(QQuickItem *webViewItem)
 {
-    qDebug() << __PRETTY_FUNCTION__ << "Configuring application webview ...";
+    TRACE_SCOPE("window", "WebApplicationWindow::configureWebView");
+
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "Configuring application webview ...";
 
     mWebView = qobject_cast<QQuickWebEngineView*>(webViewItem);
 
     if (!mWebView) {
-        qWarning() << __PRETTY_FUNCTION__ << "Couldn't find webView";
+        qCWarning(lcWindow) << __PRETTY_FUNCTION__ << "Couldn't find webView";
         return;
     }
 
@@ -294,14 +355,33 @@ void WebApplicationWindow::configureWebView(QQuickItem *webViewItem)
     connect(mWebView, SIGNAL(newViewRequested(QQuickWebEngineNewViewRequest*)),
             this, SLOT(onCreateNewPage(QQuickWebEngineNewViewRequest*)));
     connect(mWebView, SIGNAL(windowCloseRequested()), this, SLOT(onClosePage()));
+    // the signal declares its enum argument unqualified, which the string
+    // based connect can't match against our slot
+    connect(mWebView, &QQuickWebEngineView::renderProcessTerminated,
+            this, &WebApplicationWindow::onRenderProcessTerminated);
+    connect(mWebView, SIGNAL(renderProcessPidChanged(qint64)),
+            this, SLOT(onRenderProcessPidChanged(qint64)));
+
+    // hosted pages end up with the profile of the host, there's nothing to
+    // configure on ours
+    bool hosted = mHeadless && mTrustScope == TrustScopeSystem &&
+                  mApplication->userAgent().isEmpty() &&
+                  SharedRendererHost::isEnabledFor(mApplication->id());
+
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    mWebView->profile()->setHttpCacheMaximumSize(pWebAppManager->deviceProfile().httpCacheSize());
 
     // Configure all the scheme handlers
-    installUrlSchemeHandlers(mWebView->profile());
+    if (!hosted)
+        installUrlSchemeHandlers(mWebView->profile());
 
     if (mTrustScope == TrustScopeSystem)
         loadAllExtensions();
 
-   mWebView->setUrl(mUrl);
+    if (hosted)
+        sharedRendererHost()->open(mWebView, mUrl);
+    else
+        mWebView->setUrl(mUrl);
 
     /* If we're running a remote site mark the window as fully loaded */
     if (mTrustScope == TrustScopeRemote)
@@ -310,18 +390,56 @@ void WebApplicationWindow::configureWebView(QQuickItem *webViewItem)
 
 void WebApplicationWindow::onStageReadyTimeout()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__;
 
     stageReady();
 }
 
 void WebApplicationWindow::onVisibleChanged(bool visible)
 {
-    qDebug() << __PRETTY_FUNCTION__ << visible;
+    LogScope logScope(mApplication->id(), mWindowId);
+
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << visible;
+
+    QJsonObject details;
+    details.insert("visible", visible);
+    notifyAppEvent("visible", details);
 
     emit visibleChanged();
 }
 
+void WebApplicationWindow::onRenderProcessTerminated(QQuickWebEngineView::RenderProcessTerminationStatus status,
+                                                     int exitCode)
+{
+    LogScope logScope(mApplication->id(), mWindowId);
+
+    // a normal exit is not worth reporting as a crash
+    if (status == QQuickWebEngineView::NormalTerminationStatus)
+        return;
+
+    qCWarning(lcWindow) << __PRETTY_FUNCTION__ << "Renderer of" << mApplication->id()
+               << "terminated with status" << status << "exit code" << exitCode;
+
+    QString reason = "crashed";
+    if (status == QQuickWebEngineView::AbnormalTerminationStatus)
+        reason = "abnormal";
+    else if (status == QQuickWebEngineView::KilledTerminationStatus)
+        reason = "killed";
+
+    QJsonObject details;
+    details.insert("reason", reason);
+    details.insert("exitCode", exitCode);
+    notifyAppEvent("crash", details);
+}
+
+void WebApplicationWindow::onRenderProcessPidChanged(qint64 pid)
+{
+    // hosted pages report the pid of the host, which makes it a shared one
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    if (pWebAppManager && pWebAppManager->getService())
+        pWebAppManager->getService()->resourceMonitor().setRendererProcess(this, mApplication->id(), pid);
+}
+
 void WebApplicationWindow::setupPage()
 {
     // We need to finish the stage preparation in case of a remote entry point
@@ -330,6 +448,12 @@ void WebApplicationWindow::setupPage()
         stageReady();
 }
 
+int WebApplicationWindow::maxRendererRestarts() const
+{
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    return pWebAppManager->deviceProfile().maxRendererRestarts();
+}
+
 double WebApplicationWindow::devicePixelRatio() const
 {
     qreal zoomFactor = Settings::LunaSettings()->layoutScale;
@@ -343,15 +467,40 @@ double WebApplicationWindow::devicePixelRatio() const
     return zoomFactor;
 }
 
+void WebApplicationWindow::notifyAppEvent(const char *event, QJsonObject details)
+{
+    WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+    if(!pWebAppManager || !pWebAppManager->getService()) return;
+
+    details.insert("windowId", mWindowId);
+    details.insert("headless", mHeadless);
+
+    pWebAppManager->getService()->notifyAppEvent(event, mApplication->id(),
+                                                 mApplication->processId(), details);
+}
+
+void WebApplicationWindow::notifyWindowCreated()
+{
+    QJsonObject details;
+    details.insert("windowType", mWindowType);
+    notifyAppEvent("windowCreated", details);
+}
+
 void WebApplicationWindow::notifyAppAboutFocusState(bool focus)
 {
-    qDebug() << "DEBUG: We become" << (focus ? "focused" : "unfocused");
+    LogScope logScope(mApplication->id(), mWindowId);
+
+    qCDebug(lcWindow) << "DEBUG: We become" << (focus ? "focused" : "unfocused");
 
     QString action = focus ? "stageActivated" : "stageDeactivated";
 
     setIsActive(focus);
     emit focusChanged();
 
+    QJsonObject details;
+    details.insert("focused", focus);
+    notifyAppEvent("focus", details);
+
     if (mTrustScope == TrustScopeSystem)
         executeScript(QString("if (window.Mojo && Mojo.%1) Mojo.%1()").arg(action));
 
@@ -360,10 +509,21 @@ void WebApplicationWindow::notifyAppAboutFocusState(bool focus)
 
 void WebApplicationWindow::onLoadingChanged(QQuickWebEngineLoadRequest *request)
 {
-    qDebug() << Q_FUNC_INFO << "id" << mApplication->id() << "status" << request->status();
+    LogScope logScope(mApplication->id(), mWindowId);
+    TRACE_SCOPE("window", "WebApplicationWindow::onLoadingChanged");
+
+    qCDebug(lcWindow) << Q_FUNC_INFO << "id" << mApplication->id() << "status" << request->status();
 
     switch (request->status()) {
     case QQuickWebEngineView::LoadStartedStatus:
+        // a new document has to subscribe to the extension events again,
+        // jumping to an anchor keeps the page
+        if (request->url().adjusted(QUrl::RemoveFragment) != mLoadingUrl.adjusted(QUrl::RemoveFragment) ||
+            request->url().fragment() == mLoadingUrl.fragment()) {
+            Q_FOREACH(BaseExtension *extension, mExtensions.values())
+                extension->holdEvents();
+        }
+        mLoadingUrl = request->url();
         setupPage();
         return;
     case QQuickWebEngineView::LoadStoppedStatus:
@@ -396,11 +556,12 @@ void WebApplicationWindow::onLoadingChanged(QQuickWebEngineLoadRequest *request)
     // will wait for the call to stageReady to come in
     if (mStagePreparing && !mStageReady) {
         if (!mWindow->isVisible() && !mStageReadyTimer.isActive()) {
-            qDebug() << Q_FUNC_INFO << "id" << mApplication->id() << "kicking stage ready timer";
-            mStageReadyTimer.start(3000);
+            qCDebug(lcWindow) << Q_FUNC_INFO << "id" << mApplication->id() << "kicking stage ready timer";
+            WebAppManager *pWebAppManager = (WebAppManager*)qGuiApp;
+            mStageReadyTimer.start(pWebAppManager->deviceProfile().stageReadyTimeout());
         }
         else {
-            qDebug() << Q_FUNC_INFO << "id" << mApplication->id() << "omitting stage ready timer as alreay active or window visible";
+            qCDebug(lcWindow) << Q_FUNC_INFO << "id" << mApplication->id() << "omitting stage ready timer as alreay active or window visible";
         }
         return;
     }
@@ -416,7 +577,7 @@ void WebApplicationWindow::onCreateNewPage(QQuickWebEngineNewViewRequest *reques
 
 void WebApplicationWindow::onClosePage()
 {
-    qDebug() << __PRETTY_FUNCTION__;
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__;
     mApplication->closeWindow(this);
 }
 
@@ -433,14 +594,14 @@ void WebApplicationWindow::createDefaultExtensions()
 
 void WebApplicationWindow::addExtension(BaseExtension *extension)
 {
-    qDebug() << "Adding extension" << extension->name();
+    qCDebug(lcWindow) << "Adding extension" << extension->name();
     mExtensions.insert(extension->name(), extension);
 }
 
 void WebApplicationWindow::loadAllExtensions()
 {
     foreach(BaseExtension *extension, mExtensions.values()) {
-        qDebug() << "Initializing extension" << extension->name();
+        qCDebug(lcWindow) << "Initializing extension" << extension->name();
         emit extensionWantsToBeAdded(extension->name(), extension);
     }
 }
@@ -455,10 +616,18 @@ bool WebApplicationWindow::eventFilter(QObject *object, QEvent *event)
             break;
         case QEvent::FocusIn:
             notifyAppAboutFocusState(true);
+            ((WebAppManager*)qGuiApp)->raiseCard(mApplication);
             break;
         case QEvent::FocusOut:
             notifyAppAboutFocusState(false);
             break;
+        case QEvent::PlatformSurface:
+            // destroy() and show() recreate the platform window
+            if (static_cast<QPlatformSurfaceEvent*>(event)->surfaceEventType() == QPlatformSurfaceEvent::SurfaceCreated)
+                setupPlatformWindow();
+            else
+                ((WebAppManager*)qGuiApp)->unregisterWindow(this);
+            break;
         default:
             break;
         }
@@ -471,14 +640,14 @@ QString WebApplicationWindow::getIdentifierForFrame(const QString& id, const QSt
 {
     QString identifier = mApplication->identifier();
 
-    qDebug() << __PRETTY_FUNCTION__ << "Decided identifier for frame" << id << "is" << identifier;
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "Decided identifier for frame" << id << "is" << identifier;
 
     return identifier;
 }
 
 void WebApplicationWindow::stagePreparing()
 {
-    qDebug() << __PRETTY_FUNCTION__ << "id" << mApplication->id();
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "id" << mApplication->id();
 
     mStagePreparing = true;
     emit readyChanged();
@@ -486,7 +655,11 @@ void WebApplicationWindow::stagePreparing()
 
 void WebApplicationWindow::stageReady()
 {
-    qDebug() << __PRETTY_FUNCTION__ << "id" << mApplication->id();
+    LogScope logScope(mApplication->id(), mWindowId);
+
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "id" << mApplication->id();
+
+    bool wasReady = ready();
 
     mStagePreparing = false;
     mStageReady = true;
@@ -494,7 +667,8 @@ void WebApplicationWindow::stageReady()
     if (mWindow && !mWindow->isVisible())
         mWindow->show();
 
-    emit readyChanged();
+    if (!wasReady)
+        emit readyChanged();
 
     mStageReadyTimer.stop();
 }
@@ -504,7 +678,7 @@ void WebApplicationWindow::show()
     if (!mWindow)
         return;
 
-    qDebug() << __PRETTY_FUNCTION__ << "id" << mApplication->id();
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "id" << mApplication->id();
 
     mWindow->show();
 }
@@ -514,7 +688,7 @@ void WebApplicationWindow::hide()
     if (!mWindow)
         return;
 
-    qDebug() << __PRETTY_FUNCTION__ << "id" << mApplication->id();
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "id" << mApplication->id();
 
     mWindow->hide();
 }
@@ -524,7 +698,7 @@ void WebApplicationWindow::focus()
     if (!mWindow)
         return;
 
-    qDebug() << __PRETTY_FUNCTION__ << "id" << mApplication->id();
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "id" << mApplication->id();
 
     /* When we're closed we have to make sure we're visible before
      * raising ourself */
@@ -540,7 +714,7 @@ void WebApplicationWindow::unfocus()
     if (!mWindow)
         return;
 
-    qDebug() << __PRETTY_FUNCTION__ << "id" << mApplication->id();
+    qCDebug(lcWindow) << __PRETTY_FUNCTION__ << "id" << mApplication->id();
 
     mWindow->lower();
     setIsActive(false);
@@ -548,6 +722,8 @@ void WebApplicationWindow::unfocus()
 
 void WebApplicationWindow::executeScript(const QString &script)
 {
+    TRACE_SCOPE("window", "WebApplicationWindow::executeScript");
+
     emit javaScriptExecNeeded(script);
 }
 
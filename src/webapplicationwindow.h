@@ -18,6 +18,7 @@
 #ifndef WEBAPPLICATIONWINDOW_H
 #define WEBAPPLICATIONWINDOW_H
 
+#include <QJsonObject>
 #include <QObject>
 #include <QQmlApplicationEngine>
 #include <QQuickWindow>
@@ -29,6 +30,7 @@
 #include <applicationenvironment.h>
 #include <webapplicationredirecthandler.h>
 
+class QQmlContext;
 class QQuickView;
 class QQuickItem;
 class QQuickWebEngineProfile;
@@ -59,6 +61,7 @@ class WebApplicationWindow : public ApplicationEnvironment
     Q_PROPERTY(bool visible READ visible NOTIFY visibleChanged)
     Q_PROPERTY(bool focus READ hasFocus NOTIFY focusChanged)
     Q_PROPERTY(double devicePixelRatio READ devicePixelRatio CONSTANT)
+    Q_PROPERTY(int maxRendererRestarts READ maxRendererRestarts CONSTANT)
 
 public:
     explicit WebApplicationWindow(WebApplication *application, const QUrl& url, const QString& windowType,
@@ -90,6 +93,7 @@ public:
     bool visible() const;
     bool hasFocus() const;
     double devicePixelRatio() const;
+    int maxRendererRestarts() const;
     bool isMainWindow() const;
 
     QQmlEngine* qmlEngine() const;
@@ -113,6 +117,9 @@ public:
     void setWindowProperty(const QString &name, const QVariant &value);
     QVariant getWindowProperty(const QString &name);
 
+    // the compositor changed a property of our window
+    void updateWindowProperty(const QString &name);
+
 Q_SIGNALS:
     void javaScriptExecNeeded(const QString &script);
     void extensionWantsToBeAdded(const QString &name, QObject *object);
@@ -136,7 +143,9 @@ private Q_SLOTS:
     void onLoadingChanged(QQuickWebEngineLoadRequest *request);
     void onStageReadyTimeout();
     void onVisibleChanged(bool visible);
-    void onWindowPropertyChanged(QPlatformWindow *window, const QString &name);
+    void onRenderProcessTerminated(QQuickWebEngineView::RenderProcessTerminationStatus status,
+                                   int exitCode);
+    void onRenderProcessPidChanged(qint64 pid);
 
 private:
     QQuickWebEngineScript *getScriptFromUrl(const QString &iscriptName, QString iUrl, QQuickWebEngineScript::InjectionPoint injectionPoint, bool forAllFrames);
@@ -151,6 +160,8 @@ private:
     QQuickWebEngineView *mWebView;
     WebApplicationRedirectHandler mRedirectHandler;
     QUrl mUrl;
+    // the url of the document loaded last, to tell anchor jumps from loads
+    QUrl mLoadingUrl;
     QString mWindowType;
     bool mKeepAlive;
     bool mStagePreparing;
@@ -161,18 +172,22 @@ private:
     TrustScope mTrustScope;
     int mWindowId;
     int mParentWindowId;
+    // set again on every platform window we get
+    QVariantMap mWindowAttributes;
     bool mLoadingAnimationDisabled;
     bool mIsActive;
 
     void assignCorrectTrustScope();
     void createAndSetup(const QVariantMap &windowAttributesMap);
-    void configureQmlEngine();
+    void setupPlatformWindow();
+    void configureQmlEngine(QQmlContext *context);
     void loadAllExtensions();
     void addExtension(BaseExtension *extension);
     void createDefaultExtensions();
-    void updateWindowProperty(const QString &name);
     void setupPage();
     void notifyAppAboutFocusState(bool focus);
+    void notifyAppEvent(const char *event, QJsonObject details = QJsonObject());
+    void notifyWindowCreated();
     void setIsActive(bool active);
 };
 
@@ -17,27 +17,49 @@
 
 #include <QDebug>
 #include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QTimer>
 #include <QtWebEngine/qtwebengineglobal.h>
+#include <QtGui/qpa/qplatformnativeinterface.h>
 
 #include "applicationdescription.h"
 #include "webappmanager.h"
 #include "webapplication.h"
+#include "webapplicationwindow.h"
 #include "webappmanagerservice.h"
+#include "logger.h"
+#include "tracing.h"
 
 namespace luna
 {
 
 WebAppManager::WebAppManager(int &argc, char **argv)
-    : QGuiApplication(argc, argv)
+    : QGuiApplication(argc, argv),
+      mDeviceProfile(DeviceProfile::detect()),
+      mProcessPolicy(RendererProcessPolicy::fromEnvironment(mDeviceProfile.maxRenderers())),
+      mMimeTableRequested(false),
+      mMimeTableLoaded(false),
+      mAppManagerSeen(false),
+      mLaunchPointsListed(false)
 {
     setApplicationName("LunaWebAppMgr");
     setQuitOnLastWindowClosed(false);
 
+    // Chromium reads its flags when the first profile is created, which is
+    // well after this
+    mProcessPolicy.apply(mDeviceProfile.chromiumFlags());
+
     QtWebEngine::initialize();
 
     connect(this, SIGNAL(aboutToQuit()), this, SLOT(onAboutToQuit()));
 
+    // one connection for all windows instead of one per window, each of
+    // them being called for every change of any window
+    if (platformNativeInterface())
+        connect(platformNativeInterface(), SIGNAL(windowPropertyChanged(QPlatformWindow*, const QString&)),
+                this, SLOT(onWindowPropertyChanged(QPlatformWindow*, const QString&)));
+
     mService = new WebAppManagerService(this);
 }
 
@@ -46,6 +68,77 @@ WebAppManager::~WebAppManager()
     onAboutToQuit();
 }
 
+void WebAppManager::prefetchMimeTable()
+{
+    // one request at a time is enough, the table changes only on app installs
+    if (mMimeTableRequested)
+        return;
+
+    try {
+        mMimeTableCall = mService->getServiceHandle().callOneReply("luna://com.palm.applicationManager/dumpMimeTable", "{}");
+        mMimeTableCall.continueWith(WebAppManager::mimeTableCallback, this);
+        mMimeTableRequested = true;
+    }  catch (LS::Error &error) {
+        qCWarning(lcManager) << "Failed to request the mime table";
+    }
+}
+
+void WebAppManager::watchMimeTable()
+{
+    LS::ServerStatusCallback callback = [this] (bool isActive) {
+        if (!isActive)
+            return true;
+
+        // the startup fetched the table already, a restarted application
+        // manager may know other apps though
+        if (mAppManagerSeen)
+            prefetchMimeTable();
+        mAppManagerSeen = true;
+
+        try {
+            mLaunchPointsListed = false;
+            mLaunchPointsCall = mService->getServiceHandle().callMultiReply("luna://com.palm.applicationManager/listLaunchPoints",
+                                                                            "{\"subscribe\":true}");
+            mLaunchPointsCall.continueWith(WebAppManager::launchPointsCallback, this);
+        }  catch (LS::Error &error) {
+            qCWarning(lcManager) << "Failed to subscribe to launch point changes";
+        }
+
+        return true;
+    };
+
+    mAppManagerStatus = mService->getServiceHandle().registerServerStatus("com.palm.applicationManager", callback);
+}
+
+bool WebAppManager::launchPointsCallback(LSHandle *handle, LSMessage *message, void *context)
+{
+    WebAppManager *manager = static_cast<WebAppManager*>(context);
+
+    // the first reply only lists what is there, the following ones tell
+    // about apps being installed or removed
+    if (manager->mLaunchPointsListed)
+        manager->prefetchMimeTable();
+    manager->mLaunchPointsListed = true;
+
+    return true;
+}
+
+bool WebAppManager::mimeTableCallback(LSHandle *handle, LSMessage *message, void *context)
+{
+    WebAppManager *manager = static_cast<WebAppManager*>(context);
+    manager->mMimeTableRequested = false;
+
+    QJsonObject response = QJsonDocument::fromJson(QByteArray(LSMessageGetPayload(message))).object();
+    if (response.value("returnValue").toBool(false)) {
+        manager->mMimeRedirects = response.value("redirects").toArray();
+        manager->mMimeTableLoaded = true;
+    }
+
+    emit manager->mimeTableLoaded();
+
+    return true;
+}
+
 bool WebAppManager::validateApplication(const ApplicationDescription& desc)
 {
     if (desc.getId().length() == 0)
@@ -59,16 +152,19 @@ bool WebAppManager::validateApplication(const ApplicationDescription& desc)
 
 WebApplication* WebAppManager::launchApp(const QString &appDesc, const QString &parameters, int64_t processId)
 {
+    TRACE_SCOPE("manager", "WebAppManager::launchApp");
+
     ApplicationDescription desc(appDesc);
 
     if (!validateApplication(desc)) {
-        qWarning("Got invalid application description for app %s",
-                 desc.getId().toUtf8().constData());
+        qCWarning(lcManager, "Got invalid application description for app %s",
+                             desc.getId().toUtf8().constData());
         return NULL;
     }
 
     if (mApplications.contains(desc.getId())) {
         WebApplication *app = mApplications.value(desc.getId());
+        raiseCard(app);
         app->relaunch(parameters);
         return app;
     }
@@ -77,16 +173,26 @@ WebApplication* WebAppManager::launchApp(const QString &appDesc, const QString &
     if (desc.getId() == "com.palm.launcher")
         windowType = "launcher";
 
+    // announce the start before the window events of the new app
+    mService->notifyAppEvent("start", desc.getId(), processId);
+
+    // the startup fetch failed, try again for the next launch
+    if (!mMimeTableLoaded)
+        prefetchMimeTable();
+
     QUrl entryPoint = desc.getEntryPoint();
     WebApplication *app = new WebApplication(this, entryPoint, windowType,
                                              desc, parameters, processId);
     connect(app, SIGNAL(closed()), this, SLOT(onApplicationClosed()));
+    connect(app, SIGNAL(stageReady()), this, SLOT(onApplicationStageReady()));
 
     this->setQuitOnLastWindowClosed(false);
 
     mApplications.insert(app->id(), app);
+    TRACE_COUNTER("manager", "runningApps", mApplications.size());
 
-    mService->notifyAppHasStarted(app->id(), app->processId());
+    raiseCard(app);
+    enforceLiveCardLimit(app);
 
     return app;
 }
@@ -94,34 +200,98 @@ WebApplication* WebAppManager::launchApp(const QString &appDesc, const QString &
 WebApplication* WebAppManager::launchUrl(const QUrl &url, const QString &windowType,
                                const QString &appDesc, const QString &parameters, int64_t processId)
 {
+    TRACE_SCOPE("manager", "WebAppManager::launchUrl");
+
     ApplicationDescription desc(appDesc);
 
     if (!validateApplication(desc)) {
-        qWarning("Got invalid application description for app %s",
-                 desc.getId().toUtf8().constData());
+        qCWarning(lcManager, "Got invalid application description for app %s",
+                             desc.getId().toUtf8().constData());
         return NULL;
     }
 
     // FIXME is this correct when launching an URL?
     if (mApplications.contains(desc.getId())) {
         WebApplication *application = mApplications.value(desc.getId());
+        raiseCard(application);
         application->relaunch(parameters);
         return application;
     }
 
     //QQuickWebViewExperimental::setFlickableViewportEnabled(desc.isFlickable());
 
+    mService->notifyAppEvent("start", desc.getId(), processId);
+
     WebApplication *app = new WebApplication(this, url, windowType, desc, parameters,
                                              processId);
     connect(app, SIGNAL(closed()), this, SLOT(onApplicationClosed()));
+    connect(app, SIGNAL(stageReady()), this, SLOT(onApplicationStageReady()));
 
     mApplications.insert(app->id(), app);
+    TRACE_COUNTER("manager", "runningApps", mApplications.size());
 
-    mService->notifyAppHasStarted(app->id(), app->processId());
+    raiseCard(app);
+    enforceLiveCardLimit(app);
 
     return app;
 }
 
+void WebAppManager::registerWindow(QPlatformWindow *platformWindow, WebApplicationWindow *window)
+{
+    unregisterWindow(window);
+
+    mPlatformWindows.insert(platformWindow, window);
+    mWindowPlatforms.insert(window, platformWindow);
+}
+
+void WebAppManager::unregisterWindow(WebApplicationWindow *window)
+{
+    if (mWindowPlatforms.contains(window))
+        mPlatformWindows.remove(mWindowPlatforms.take(window));
+}
+
+void WebAppManager::onWindowPropertyChanged(QPlatformWindow *platformWindow, const QString &name)
+{
+    WebApplicationWindow *window = mPlatformWindows.value(platformWindow);
+    if (window)
+        window->updateWindowProperty(name);
+}
+
+void WebAppManager::raiseCard(WebApplication *app)
+{
+    // headless apps and the launcher don't take a card slot
+    if (app->headless() || app->id() == "com.palm.launcher")
+        return;
+
+    mCardOrder.removeOne(app->id());
+    mCardOrder.append(app->id());
+}
+
+void WebAppManager::enforceLiveCardLimit(WebApplication *launchedApp)
+{
+    int maxLiveCards = mDeviceProfile.maxLiveCards();
+    if (maxLiveCards <= 0)
+        return;
+
+    int n = 0;
+    while (mCardOrder.size() > maxLiveCards && n < mCardOrder.size()) {
+        QString appId = mCardOrder.at(n);
+        WebApplication *app = mApplications.value(appId);
+
+        // cards kept alive or showing a dashboard are not ours to close
+        if (appId == launchedApp->id() || (app && app->hasPersistentWindows())) {
+            n++;
+            continue;
+        }
+
+        qCInfo(lcManager) << "Closing" << appId << "to stay within" << maxLiveCards << "live cards";
+
+        // killing closes the app right away, which takes it off the order too
+        mCardOrder.removeAt(n);
+        killApp(appId);
+    }
+}
+
 void WebAppManager::onAboutToQuit()
 {
 }
@@ -131,18 +301,28 @@ void WebAppManager::onApplicationClosed()
     WebApplication *app = static_cast<WebApplication*>(sender());
 
     if (!mApplications.contains(app->id())) {
-        qWarning("BUG: Got close event from not running application!?");
+        qCWarning(lcManager, "BUG: Got close event from not running application!?");
         return;
     }
 
     mApplications.remove(app->id());
+    mCardOrder.removeOne(app->id());
+    TRACE_COUNTER("manager", "runningApps", mApplications.size());
 
-    mService->notifyAppHasFinished(app->id(), app->processId());
+    mService->notifyAppEvent("close", app->id(), app->processId());
+    mService->resourceMonitor().forgetApplication(app->id());
 
-    qDebug() << "Application" << app->id() << "was closed";
+    qCDebug(lcManager) << "Application" << app->id() << "was closed";
     delete app;
 }
 
+void WebAppManager::onApplicationStageReady()
+{
+    WebApplication *app = static_cast<WebApplication*>(sender());
+
+    mService->notifyAppEvent("stageReady", app->id(), app->processId());
+}
+
 void WebAppManager::killApp(const QString &appId)
 {
     WebApplication *appToKill = 0;
@@ -197,6 +377,7 @@ bool WebAppManager::relaunch(const QString &appId, const QString &params)
     if (!targetApp)
         return false;
 
+    raiseCard(targetApp);
     targetApp->relaunch(params);
 
     return true;
@@ -26,12 +26,23 @@
 #include <QFile>
 #include <QTextStream>
 #include <QStringList>
+#include <QJsonArray>
+#include <QHash>
+
+class QPlatformWindow;
+
+#include <luna-service2++/call.hpp>
+#include <luna-service2++/server_status.hpp>
+
+#include "deviceprofile.h"
+#include "rendererprocesspolicy.h"
 
 namespace luna
 {
 
 class ApplicationDescription;
 class WebApplication;
+class WebApplicationWindow;
 class WebAppManagerService;
 
 class WebAppManager : public QGuiApplication
@@ -59,15 +70,51 @@ public:
 
     WebAppManagerService *getService() { return mService; }
 
+    void prefetchMimeTable();
+    // fetch the table again whenever the installed apps change
+    void watchMimeTable();
+    bool hasMimeTable() const { return mMimeTableLoaded; }
+    QJsonArray mimeRedirects() const { return mMimeRedirects; }
+
+    void registerWindow(QPlatformWindow *platformWindow, WebApplicationWindow *window);
+    void unregisterWindow(WebApplicationWindow *window);
+
+    const DeviceProfile &deviceProfile() const { return mDeviceProfile; }
+    void raiseCard(WebApplication *app);
+    const RendererProcessPolicy &processPolicy() const { return mProcessPolicy; }
+
+Q_SIGNALS:
+    void mimeTableLoaded();
+
 private Q_SLOTS:
     void onApplicationClosed();
+    void onApplicationStageReady();
     void onAboutToQuit();
+    void onWindowPropertyChanged(QPlatformWindow *platformWindow, const QString &name);
 
 private:
     WebAppManagerService *mService;
+    DeviceProfile mDeviceProfile;
+    RendererProcessPolicy mProcessPolicy;
+    // ids of the running cards, least recently used first
+    QStringList mCardOrder;
+    QHash<QPlatformWindow*, WebApplicationWindow*> mPlatformWindows;
+    QHash<WebApplicationWindow*, QPlatformWindow*> mWindowPlatforms;
     QMap<QString,WebApplication*> mApplications;
+    LS::Call mMimeTableCall;
+    bool mMimeTableRequested;
+    bool mMimeTableLoaded;
+    QJsonArray mMimeRedirects;
+    LS::ServerStatus mAppManagerStatus;
+    LS::Call mLaunchPointsCall;
+    bool mAppManagerSeen;
+    bool mLaunchPointsListed;
+
+    static bool mimeTableCallback(LSHandle *handle, LSMessage *message, void *context);
+    static bool launchPointsCallback(LSHandle *handle, LSMessage *message, void *context);
 
     bool validateApplication(const ApplicationDescription& desc);
+    void enforceLiveCardLimit(WebApplication *launchedApp);
 };
 
 } // namespace luna
@@ -15,21 +15,172 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>
  */
 
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QUrl>
 
-#include "utils.h"
+#include "jsonwriter.h"
 #include "webapplication.h"
 #include "webappmanager.h"
 #include "webappmanagerservice.h"
 #include "lunaserviceutils.h"
+#include "logger.h"
+#include "tracing.h"
 
 #define WEBAPPMANAGER_SERVICE_ID    "org.webosports.webappmanager"
+#define TRACE_DIRECTORY_NAME        "webappmanager-traces"
 
 namespace luna
 {
 
+namespace
+{
+
+// indexed by WebAppManagerService::RequestSchema
+const char *requestSchemas[] = {
+    // launchApp, params of any other type than object or string are ignored
+    "{\"type\":\"object\",\"properties\":{"
+        "\"appDesc\":{\"type\":\"object\"},"
+        "\"params\":{},"
+        "\"processId\":{\"type\":\"integer\"}},"
+        "\"required\":[\"appDesc\",\"processId\"],"
+        "\"additionalProperties\":true}",
+    // launchUrl, appDesc and params other than objects are ignored
+    "{\"type\":\"object\",\"properties\":{"
+        "\"url\":{\"type\":\"string\"},"
+        "\"windowType\":{\"type\":\"string\"},"
+        "\"appDesc\":{},"
+        "\"params\":{},"
+        "\"processId\":{\"type\":\"integer\"}},"
+        "\"required\":[\"url\",\"processId\"],"
+        "\"additionalProperties\":true}",
+    // killApp
+    "{\"type\":\"object\",\"properties\":{"
+        "\"appId\":{\"type\":\"string\"},"
+        "\"processId\":{\"type\":\"integer\"}}}",
+    // isAppRunning
+    "{\"type\":\"object\",\"properties\":{"
+        "\"appId\":{\"type\":\"string\"}},"
+        "\"required\":[\"appId\"]}",
+    // listRunningApps
+    "{\"type\":\"object\",\"properties\":{"
+        "\"details\":{\"type\":\"boolean\"}}}",
+    // registerForAppEvents
+    "{\"type\":\"object\",\"properties\":{"
+        "\"subscribe\":{\"type\":\"boolean\"},"
+        "\"appIds\":{\"type\":\"array\",\"items\":{\"type\":\"string\"}},"
+        "\"events\":{\"type\":\"array\",\"items\":{\"type\":\"string\"}},"
+        "\"since\":{\"type\":\"integer\"}}}",
+    // relaunch, params other than a string are ignored
+    "{\"type\":\"object\",\"properties\":{"
+        "\"appId\":{\"type\":\"string\"},"
+        "\"params\":{}},"
+        "\"required\":[\"appId\"]}",
+    // clearMemoryCaches
+    "{\"type\":\"object\",\"properties\":{"
+        "\"appId\":{\"type\":\"string\"},"
+        "\"processId\":{\"type\":\"integer\"}}}",
+    // getAppResourceUsage
+    "{\"type\":\"object\",\"properties\":{"
+        "\"subscribe\":{\"type\":\"boolean\"},"
+        "\"appId\":{\"type\":\"string\"}}}",
+    // setLogLevel
+    "{\"type\":\"object\",\"properties\":{"
+        "\"category\":{\"type\":\"string\"},"
+        "\"level\":{\"enum\":[\"debug\",\"info\",\"warning\",\"critical\"]}},"
+        "\"required\":[\"level\"]}",
+    // setBridgeTracing
+    "{\"type\":\"object\",\"properties\":{"
+        "\"appId\":{\"type\":\"string\"},"
+        "\"enable\":{\"type\":\"boolean\"}},"
+        "\"required\":[\"appId\",\"enable\"]}",
+    // getBridgeTrace
+    "{\"type\":\"object\",\"properties\":{"
+        "\"appId\":{\"type\":\"string\"},"
+        "\"clear\":{\"type\":\"boolean\"}},"
+        "\"required\":[\"appId\"]}",
+    // startTrace
+    "{\"type\":\"object\"}",
+    // stopTrace
+    "{\"type\":\"object\",\"properties\":{"
+        "\"fileName\":{\"type\":\"string\"}}}",
+    // getBridgeStats
+    "{\"type\":\"object\",\"properties\":{"
+        "\"appId\":{\"type\":\"string\"},"
+        "\"uri\":{\"type\":\"string\"},"
+        "\"clear\":{\"type\":\"boolean\"}}}",
+    // getProcessPolicy
+    "{\"type\":\"object\"}",
+    // getDeviceProfile
+    "{\"type\":\"object\"}",
+};
+
+// The schemas already checked the types, these only pick the values out.
+
+bool hasField(jvalue_ref object, const char *key)
+{
+    jvalue_ref value;
+    return jobject_get_exists(object, j_cstr_to_buffer(key), &value);
+}
+
+// For the fields the schema leaves untyped to stay as lenient as before
+bool hasField(jvalue_ref object, const char *key, bool (*isType)(jvalue_ref))
+{
+    jvalue_ref value;
+    return jobject_get_exists(object, j_cstr_to_buffer(key), &value) && isType(value);
+}
+
+QString stringField(jvalue_ref object, const char *key)
+{
+    jvalue_ref value;
+    if (!jobject_get_exists(object, j_cstr_to_buffer(key), &value) || !jis_string(value))
+        return QString();
+
+    raw_buffer buffer = jstring_get_fast(value);
+    return QString::fromUtf8(buffer.m_str, buffer.m_len);
+}
+
+int64_t integerField(jvalue_ref object, const char *key)
+{
+    jvalue_ref value;
+    int64_t number = 0;
+
+    if (jobject_get_exists(object, j_cstr_to_buffer(key), &value) && jis_number(value))
+        jnumber_get_i64(value, &number);
+
+    return number;
+}
+
+bool booleanField(jvalue_ref object, const char *key)
+{
+    jvalue_ref value;
+    bool result = false;
+
+    if (jobject_get_exists(object, j_cstr_to_buffer(key), &value) && jis_boolean(value))
+        jboolean_get(value, &result);
+
+    return result;
+}
+
+// Nested objects are handed on as JSON text, a string is passed through as is
+QString serializedField(jvalue_ref object, const char *key)
+{
+    jvalue_ref value;
+    if (!jobject_get_exists(object, j_cstr_to_buffer(key), &value))
+        return QString();
+
+    if (jis_string(value))
+        return stringField(object, key);
+
+    if (!jis_object(value))
+        return QString();
+
+    return QString::fromUtf8(jvalue_tostring(value, jschema_all()));
+}
+
+} // namespace
+
 /*! \page org_webosports_webappmanager Service API org.webosports.webappmanager
  *
  * Public methods:
@@ -38,12 +189,26 @@ namespace luna
  * - \ref org_webosports_webappmanager_kill_app
  * - \ref org_webosports_webappmanager_is_app_running
  * - \ref org_webosports_webappmanager_list_running_apps
+ * - \ref org_webosports_webappmanager_register_for_app_events
+ * - \ref org_webosports_webappmanager_get_app_resource_usage
+ * - \ref org_webosports_webappmanager_set_log_level
+ * - \ref org_webosports_webappmanager_set_bridge_tracing
+ * - \ref org_webosports_webappmanager_get_bridge_trace
+ * - \ref org_webosports_webappmanager_start_trace
+ * - \ref org_webosports_webappmanager_stop_trace
+ * - \ref org_webosports_webappmanager_get_bridge_stats
+ * - \ref org_webosports_webappmanager_get_process_policy
+ * - \ref org_webosports_webappmanager_get_device_profile
  */
 
 WebAppManagerService::WebAppManagerService(WebAppManager *webAppManager)
     : LS::Handle(LS::registerService(WEBAPPMANAGER_SERVICE_ID, false)),
-      mWebAppManager(webAppManager)
+      mWebAppManager(webAppManager),
+      mResourceMonitor(webAppManager)
 {
+    for (int n = 0; n < RequestSchemaCount; n++)
+        mSchemas[n] = luna_service_compile_schema(requestSchemas[n]);
+
     attachToLoop(g_main_loop_new(g_main_context_default(), FALSE));
 
     LS_CATEGORY_BEGIN(WebAppManagerService, "/")
@@ -55,13 +220,66 @@ WebAppManagerService::WebAppManagerService(WebAppManager *webAppManager)
         LS_CATEGORY_METHOD(registerForAppEvents)
         LS_CATEGORY_METHOD(relaunch)
         LS_CATEGORY_METHOD(clearMemoryCaches)
+        LS_CATEGORY_METHOD(getAppResourceUsage)
+        LS_CATEGORY_METHOD(setLogLevel)
+        LS_CATEGORY_METHOD(setBridgeTracing)
+        LS_CATEGORY_METHOD(getBridgeTrace)
+        LS_CATEGORY_METHOD(startTrace)
+        LS_CATEGORY_METHOD(stopTrace)
+        LS_CATEGORY_METHOD(getBridgeStats)
+        LS_CATEGORY_METHOD(getProcessPolicy)
+        LS_CATEGORY_METHOD(getDeviceProfile)
     LS_CATEGORY_END
 
-    mAppEventSubscriptions.setServiceHandle(this);
+    mAppEvents.setServiceHandle(this);
+    mResourceMonitor.setServiceHandle(this);
 }
 
 WebAppManagerService::~WebAppManagerService()
 {
+    for (int n = 0; n < RequestSchemaCount; n++) {
+        if (mSchemas[n])
+            jschema_release(&mSchemas[n]);
+    }
+}
+
+jvalue_ref WebAppManagerService::parseRequest(LS::Message &request, RequestSchema schema)
+{
+    jvalue_ref root = luna_service_message_parse_with_schema(request.getPayload(), mSchemas[schema]);
+    if (root)
+        return root;
+
+    // callers know the replies for a missing field from before the schemas
+    static const struct { RequestSchema schema; const char *name; const char *errorText; } requiredFields[] = {
+        { LaunchAppSchema, "appDesc", "No application description provided" },
+        { LaunchAppSchema, "processId", "No process id provided" },
+        { LaunchUrlSchema, "url", "No URL to launch provided" },
+        { LaunchUrlSchema, "processId", "No process id provided" },
+        { IsAppRunningSchema, "appId", "Missing appId parameter" },
+        { RelaunchSchema, "appId", "Missing appId parameter" },
+    };
+
+    // only rejected requests pay for a second parse to tell the errors apart
+    jvalue_ref plain = luna_service_message_parse_and_validate(request.getPayload());
+    if (plain && jis_object(plain)) {
+        const char *errorText = 0;
+        for (unsigned int n = 0; n < sizeof(requiredFields) / sizeof(requiredFields[0]) && !errorText; n++) {
+            if (requiredFields[n].schema == schema && !hasField(plain, requiredFields[n].name))
+                errorText = requiredFields[n].errorText;
+        }
+
+        if (errorText)
+            luna_service_message_reply_custom_error(LS::Handle::get(), request.get(), errorText);
+        else
+            luna_service_message_reply_error_invalid_params(LS::Handle::get(), request.get());
+    }
+    else
+        luna_service_message_reply_error_bad_json(LS::Handle::get(), request.get());
+
+    if (plain)
+        j_release(&plain);
+
+    return NULL;
 }
 
 /*!
@@ -127,57 +345,31 @@ bool WebAppManagerService::launchApp(LSMessage &message)
 {
     LS::Message request(&message);
 
-    QByteArray payload(request.getPayload());
-    if (payload.isEmpty()) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"Bad JSON\"}");
+    jvalue_ref root = parseRequest(request, LaunchAppSchema);
+    if (!root)
         return true;
-    }
 
-    QJsonDocument requestDocument = QJsonDocument::fromJson(payload);
-    if (!requestDocument.isObject()) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"Bad JSON\"}");
-        return true;
-    }
+    QString appDesc = serializedField(root, "appDesc");
+    QString params = serializedField(root, "params");
+    int64_t processId = integerField(root, "processId");
 
-    QJsonObject rootObject = requestDocument.object();
-    if (!(rootObject.contains("appDesc") && rootObject.value("appDesc").isObject())) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"No application description provided\"}");
-        return true;
-    }
-
-    if (!rootObject.contains("processId")) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"No process id provided\"}");
-        return true;
-    }
-
-    QString appDesc = jsonObjectToString(rootObject.value("appDesc").toObject());
-    QString params = "";
-
-    if (rootObject.contains("params")) {
-        if (rootObject.value("params").isObject())
-            params = jsonObjectToString(rootObject.value("params").toObject());
-        else
-            params = rootObject.value("params").toString();
-    }
-
-    int processId = rootObject.value("processId").toInt();
+    j_release(&root);
 
     WebApplication *app = mWebAppManager->launchApp(appDesc, params, processId);
 
-    QJsonObject response;
+    JsonWriter response(&mResponseBuffer);
 
-    response.insert("returnValue", QJsonValue(app != 0));
+    response.beginObject();
+    response.member("returnValue", app != 0);
 
     if (!app)
-        response.insert("errorText", QJsonValue(QString("Failed to launch application")));
+        response.member("errorText", "Failed to launch application");
     else
-        response.insert("processId", QJsonValue((qint64) app->processId()));
-
-    response.insert("returnValue", QJsonValue(app != 0));
+        response.member("processId", (qint64) app->processId());
 
-    QJsonDocument responseDocument(response);
+    response.endObject();
 
-    request.respond(responseDocument.toJson().constData());
+    request.respond(response.constData());
 
     return true;
 }
@@ -186,62 +378,42 @@ bool WebAppManagerService::launchUrl(LSMessage &message)
 {
     LS::Message request(&message);
 
-    QByteArray payload(request.getPayload());
-    if (payload.isEmpty()) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"Bad JSON\"}");
+    jvalue_ref root = parseRequest(request, LaunchUrlSchema);
+    if (!root)
         return true;
-    }
-
-    QJsonDocument requestDocument = QJsonDocument::fromJson(payload);
-    if (!requestDocument.isObject()) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"Bad JSON\"}");
-        return true;
-    }
-
-    QJsonObject rootObject = requestDocument.object();
-
-    if (!(rootObject.contains("url") && rootObject.value("url").isString())) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"No URL to launch provided\"}");
-        return true;
-    }
-
-    if (!rootObject.contains("processId")) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"No process id provided\"}");
-        return true;
-    }
 
-    QUrl url(rootObject.value("url").toString());
+    QUrl url(stringField(root, "url"));
 
     QString windowType = "card";
-    if (rootObject.contains("windowType") && rootObject.value("windowType").isString())
-        windowType = rootObject.value("windowType").toString();
+    if (hasField(root, "windowType"))
+        windowType = stringField(root, "windowType");
 
-    QString appDesc = "";
-    if (rootObject.contains("appDesc") && rootObject.value("appDesc").isObject())
-        appDesc = jsonObjectToString(rootObject.value("appDesc").toObject());
+    QString appDesc;
+    if (hasField(root, "appDesc", jis_object))
+        appDesc = serializedField(root, "appDesc");
 
-    QString params = "";
-    if (rootObject.contains("params") && rootObject.value("params").isObject())
-        params = jsonObjectToString(rootObject.value("params").toObject());
+    QString params;
+    if (hasField(root, "params", jis_object))
+        params = serializedField(root, "params");
+    int64_t processId = integerField(root, "processId");
 
-    int processId = rootObject.value("processId").toInt();
+    j_release(&root);
 
     WebApplication *app = mWebAppManager->launchUrl(url, windowType, appDesc, params, processId);
 
-    QJsonObject response;
+    JsonWriter response(&mResponseBuffer);
 
-    response.insert("returnValue", QJsonValue(app != 0));
+    response.beginObject();
+    response.member("returnValue", app != 0);
 
     if (!app)
-        response.insert("errorText", QJsonValue(QString("Failed to launch application")));
+        response.member("errorText", "Failed to launch application");
     else
-        response.insert("processId", QJsonValue((qint64) app->processId()));
+        response.member("processId", (qint64) app->processId());
 
-    response.insert("returnValue", QJsonValue(app != 0));
+    response.endObject();
 
-    QJsonDocument responseDocument(response);
-
-    request.respond(responseDocument.toJson().constData());
+    request.respond(response.constData());
 
     return true;
 }
@@ -250,20 +422,22 @@ bool WebAppManagerService::killApp(LSMessage &message)
 {
     LS::Message request(&message);
 
-    QJsonDocument document = QJsonDocument::fromJson(request.getPayload());
+    jvalue_ref root = parseRequest(request, KillAppSchema);
+    if (!root)
+        return true;
+
+    bool found = true;
+    if (hasField(root, "processId"))
+        mWebAppManager->killApp(integerField(root, "processId"));
+    else if (hasField(root, "appId"))
+        mWebAppManager->killApp(stringField(root, "appId"));
+    else
+        found = false;
 
-    QJsonObject root = document.object();
+    j_release(&root);
 
-    if (root.contains("processId")) {
-        int64_t processId = root.value("processId").toInt();
-        mWebAppManager->killApp(processId);
-    }
-    else if (root.contains("appId")) {
-        QString appId = root.value("appId").toString();
-        mWebAppManager->killApp(appId);
-    }
-    else {
-        request.respond("\"returnValue\":false,\"errorText\":\"Missing appId or processId parameter\"}");
+    if (!found) {
+        request.respond("{\"returnValue\":false,\"errorText\":\"Missing appId or processId parameter\"}");
         return true;
     }
 
@@ -276,21 +450,36 @@ bool WebAppManagerService::listRunningApps(LSMessage &message)
 {
     LS::Message request(&message);
 
-    QJsonObject rootObj;
+    jvalue_ref root = parseRequest(request, ListRunningAppsSchema);
+    if (!root)
+        return true;
 
-    QJsonArray runningApps;
-    Q_FOREACH(WebApplication *app, mWebAppManager->applications()) {
-        QJsonObject appObj;
-        appObj.insert("appId", app->id());
-        appObj.insert("processId", (qint64) app->processId());
-        runningApps.append(QJsonValue(appObj));
-    }
+    bool details = booleanField(root, "details");
 
-    rootObj.insert("apps", runningApps);
+    j_release(&root);
 
-    QJsonDocument document(rootObj);
+    // reading /proc for every renderer isn't free, only do it when asked
+    if (details)
+        mResourceMonitor.sample();
 
-    request.respond(document.toJson().constData());
+    JsonWriter response(&mResponseBuffer);
+
+    response.beginObject();
+    response.key("apps").beginArray();
+    Q_FOREACH(WebApplication *app, mWebAppManager->applications()) {
+        response.beginObject();
+        response.member("appId", app->id());
+        response.member("processId", (qint64) app->processId());
+        if (details) {
+            response.key("resources");
+            mResourceMonitor.writeUsage(response, app->id());
+        }
+        response.endObject();
+    }
+    response.endArray();
+    response.endObject();
+
+    request.respond(response.constData());
 
     return true;
 }
@@ -299,77 +488,108 @@ bool WebAppManagerService::isAppRunning(LSMessage &message)
 {
     LS::Message request(&message);
 
-    QJsonDocument document = QJsonDocument::fromJson(QByteArray(request.getPayload()));
-
-    QJsonObject root = document.object();
-
-    if (!root.contains("appId")) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"Missing appId parameter\"}");
+    jvalue_ref root = parseRequest(request, IsAppRunningSchema);
+    if (!root)
         return true;
-    }
 
-    QString appId = root.value("appId").toString();
+    bool running = mWebAppManager->isAppRunning(stringField(root, "appId"));
 
-    bool running = mWebAppManager->isAppRunning(appId);
-    QString response = QString("{\"returnValue\":true,\"running\":%1}").arg(running ? "true" : "false");
+    j_release(&root);
 
-    request.respond(response.toUtf8().constData());
+    request.respond(running ? "{\"returnValue\":true,\"running\":true}" :
+                              "{\"returnValue\":true,\"running\":false}");
 
     return true;
 }
 
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_register_for_app_events registerForAppEvents
+
+\e Private
+
+org.webosports.webappmanager/registerForAppEvents
+
+Subscribe to the lifecycle events of the running applications.
+
+\subsection org_webosports_webappmanager_register_for_app_events_syntax Syntax:
+\code
+{
+    "subscribe": true,
+    "appIds": [string],
+    "events": [string],
+    "since": integer
+}
+\endcode
+
+\param appIds Only deliver events of these applications (optional).
+\param events Only deliver these event types (optional): start, close,
+windowCreated, windowDestroyed, stageReady, focus, visible and crash.
+\param since Sequence number of the last event seen, the newer ones still
+kept by the service are replayed right after subscribing (optional).
+
+\subsection org_webosports_webappmanager_register_for_app_events_returns Returns:
+\code
+{
+    "returnValue": boolean,
+    "subscribed": boolean,
+    "sequence": integer,
+    "replayComplete": boolean
+}
+\endcode
+
+\param sequence Sequence number of the latest event posted.
+\param replayComplete False if events after \e since were dropped already or
+the service was restarted meanwhile; only present when \e since was given.
+
+Every event carries "event", "sequence", "timestamp", "appId" and "processId",
+window events also "windowId" and "headless". windowCreated is posted once
+the compositor assigned the window id, right away for headless windows.
+*/
 bool WebAppManagerService::registerForAppEvents(LSMessage &message)
 {
     LS::Message request(&message);
 
+    jvalue_ref root = parseRequest(request, RegisterForAppEventsSchema);
+    if (!root)
+        return true;
+
     if (!request.isSubscription()) {
+        j_release(&root);
         request.respond("{\"returnValue\":false,\"errorText\":\"You can only subscribe to this method\"}");
         return true;
     }
 
-    mAppEventSubscriptions.subscribe(request);
+    if (!mAppEvents.subscribe(request, root))
+        request.respond("{\"returnValue\":false,\"errorText\":\"Failed to add subscription\"}");
 
-    request.respond("{\"returnValue\":true}");
+    j_release(&root);
 
     return true;
 }
 
-void WebAppManagerService::notifyAppHasStarted(const QString &appId, int64_t processId)
-{
-    QString payload = QString("{\"event\":\"start\",\"appId\":\"%1\",\"processId\":%2}")
-                        .arg(appId)
-                        .arg(processId);
-
-    mAppEventSubscriptions.post(payload.toUtf8().constData());
-}
-
-void WebAppManagerService::notifyAppHasFinished(const QString &appId, int64_t processId)
+void WebAppManagerService::notifyAppEvent(const char *event, const QString &appId, int64_t processId,
+                                          const QJsonObject &details)
 {
-    QString payload = QString("{\"event\":\"close\",\"appId\":\"%1\",\"processId\":%2}")
-                        .arg(appId)
-                        .arg(processId);
-
-    mAppEventSubscriptions.post(payload.toUtf8().constData());
+    mAppEvents.post(event, appId, processId, details);
 }
 
 bool WebAppManagerService::relaunch(LSMessage &message)
 {
     LS::Message request(&message);
 
-    QJsonDocument document = QJsonDocument::fromJson(QByteArray(request.getPayload()));
-
-    QJsonObject root = document.object();
-
-    if (!root.contains("appId")) {
-        request.respond("{\"returnValue\":false,\"errorText\":\"Missing appId parameter\"}");
+    jvalue_ref root = parseRequest(request, RelaunchSchema);
+    if (!root)
         return true;
-    }
 
-    QString appId = root.value("appId").toString();
+    QString appId = stringField(root, "appId");
 
     QString params = "{}";
-    if (root.contains("params") && root.value("params").isString())
-        params = root.value("params").toString();
+    if (hasField(root, "params", jis_string))
+        params = stringField(root, "params");
+
+    j_release(&root);
 
     bool success = mWebAppManager->relaunch(appId, params);
     if (!success)
@@ -384,28 +604,686 @@ bool WebAppManagerService::clearMemoryCaches(LSMessage &message)
 {
     LS::Message request(&message);
 
-    QJsonDocument document = QJsonDocument::fromJson(QByteArray(request.getPayload()));
-
-    QJsonObject root = document.object();
+    jvalue_ref root = parseRequest(request, ClearMemoryCachesSchema);
+    if (!root)
+        return true;
 
-    if (!root.contains("appId") || !root.contains("processId")) {
+    if (!hasField(root, "appId") || !hasField(root, "processId")) {
         // If no appId or processId provided we clean the caches for all apps
         mWebAppManager->clearMemoryCaches();
     }
     else {
-        if (root.contains("processId")) {
-            qint64 processId = root.value("processId").toInt();
+        if (hasField(root, "processId")) {
+            qint64 processId = integerField(root, "processId");
             mWebAppManager->clearMemoryCaches(processId);
         }
-        else if (root.contains("appId")) {
-            QString appId = root.value("appId").toString();
-            mWebAppManager->clearMemoryCaches(appId);
+        else if (hasField(root, "appId")) {
+            mWebAppManager->clearMemoryCaches(stringField(root, "appId"));
         }
     }
 
+    j_release(&root);
+
     request.respond("{\"returnValue\":true}");
 
     return true;
 }
 
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_get_app_resource_usage getAppResourceUsage
+
+\e Private
+
+org.webosports.webappmanager/getAppResourceUsage
+
+Report the resources used by the renderer processes of the running
+applications. Subscribers get an update every five seconds. The same
+"resources" object is added to the entries of listRunningApps when it is
+called with "details": true.
+
+\subsection org_webosports_webappmanager_get_app_resource_usage_syntax Syntax:
+\code
+{
+    "subscribe": boolean,
+    "appId": string
+}
+\endcode
+
+\param appId Only report this application (optional).
+
+\subsection org_webosports_webappmanager_get_app_resource_usage_returns Returns:
+\code
+{
+    "returnValue": boolean,
+    "subscribed": boolean,
+    "apps": [{
+        "appId": string,
+        "processId": integer,
+        "resources": {
+            "processes": [integer],
+            "cpuTime": integer,
+            "cpuUsage": number,
+            "pss": integer,
+            "readBytes": integer,
+            "writeBytes": integer,
+            "shared": [{
+                "processId": integer,
+                "appIds": [string],
+                "cpuTime": integer,
+                "cpuUsage": number,
+                "pss": integer,
+                "readBytes": integer,
+                "writeBytes": integer
+            }]
+        }
+    }]
+}
+\endcode
+
+\param processes Renderers only rendering pages of this application.
+\param cpuTime CPU time in milliseconds the renderers consumed so far.
+\param cpuUsage CPU usage in percent since the previous sample. Subscribers
+and one-off queries are sampled independently.
+\param pss Proportional set size of the renderers in kB.
+\param readBytes Bytes the renderers read from storage.
+\param writeBytes Bytes the renderers wrote to storage.
+\param shared Renderers also rendering pages of other applications, they are
+not included in the totals above.
+*/
+bool WebAppManagerService::getAppResourceUsage(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, GetAppResourceUsageSchema);
+    if (!root)
+        return true;
+
+    QString appId = stringField(root, "appId");
+
+    j_release(&root);
+
+    if (!appId.isEmpty() && !mWebAppManager->isAppRunning(appId)) {
+        request.respond("{\"returnValue\":false,\"errorText\":\"App is not running\"}");
+        return true;
+    }
+
+    bool subscribed = request.isSubscription() && mResourceMonitor.subscribe(request, appId);
+
+    mResourceMonitor.sample();
+
+    JsonWriter response(&mResponseBuffer);
+
+    response.beginObject();
+    response.member("returnValue", true);
+    response.member("subscribed", subscribed);
+    response.key("apps").beginArray();
+    Q_FOREACH(WebApplication *app, mWebAppManager->applications()) {
+        if (!appId.isEmpty() && app->id() != appId)
+            continue;
+
+        response.beginObject();
+        response.member("appId", app->id());
+        response.member("processId", (qint64) app->processId());
+        response.key("resources");
+        mResourceMonitor.writeUsage(response, app->id());
+        response.endObject();
+    }
+    response.endArray();
+    response.endObject();
+
+    request.respond(response.constData());
+
+    return true;
+}
+
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_set_log_level setLogLevel
+
+\e Private
+
+org.webosports.webappmanager/setLogLevel
+
+Change the lowest level logged for a category at runtime. Debug messages
+are off unless the manager runs with --verbose.
+
+\subsection org_webosports_webappmanager_set_log_level_syntax Syntax:
+\code
+{
+    "category": string,
+    "level": string
+}
+\endcode
+
+\param category Logging category, for example webappmanager.window. Its
+subcategories follow it. Without a category the level applies to all of them.
+\param level One of debug, info, warning or critical.
+
+\subsection org_webosports_webappmanager_set_log_level_returns Returns:
+\code
+{
+    "returnValue": boolean,
+    "levels": object
+}
+\endcode
+
+\param levels All levels set so far by category.
+*/
+bool WebAppManagerService::setLogLevel(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, SetLogLevelSchema);
+    if (!root)
+        return true;
+
+    QString category = stringField(root, "category");
+    QString level = stringField(root, "level");
+
+    j_release(&root);
+
+    if (category.isEmpty())
+        category = "*";
+
+    Logger::instance()->setLevel(category, level);
+
+    JsonWriter response(&mResponseBuffer);
+
+    response.beginObject();
+    response.member("returnValue", true);
+    response.key("levels").beginObject();
+    QMap<QString, QString> levels = Logger::instance()->levels();
+    for (QMap<QString, QString>::const_iterator it = levels.constBegin(); it != levels.constEnd(); ++it)
+        response.member(it.key().toUtf8().constData(), it.value());
+    response.endObject();
+    response.endObject();
+
+    request.respond(response.constData());
+
+    return true;
+}
+
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_set_bridge_tracing setBridgeTracing
+
+\e Private
+
+org.webosports.webappmanager/setBridgeTracing
+
+Start or stop recording the bridge calls of an application's pages. The
+running windows of the app follow right away, new ones start with the
+current setting.
+
+\subsection org_webosports_webappmanager_set_bridge_tracing_syntax Syntax:
+\code
+{
+    "appId": string,
+    "enable": boolean
+}
+\endcode
+*/
+bool WebAppManagerService::setBridgeTracing(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, SetBridgeTracingSchema);
+    if (!root)
+        return true;
+
+    mBridgeTrace.setEnabled(stringField(root, "appId"), booleanField(root, "enable"));
+
+    j_release(&root);
+
+    request.respond("{\"returnValue\":true}");
+
+    return true;
+}
+
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_get_bridge_trace getBridgeTrace
+
+\e Private
+
+org.webosports.webappmanager/getBridgeTrace
+
+Return the last 512 bridge calls recorded for an application.
+
+\subsection org_webosports_webappmanager_get_bridge_trace_syntax Syntax:
+\code
+{
+    "appId": string,
+    "clear": boolean
+}
+\endcode
+
+\param clear Drop the returned records (optional).
+
+\subsection org_webosports_webappmanager_get_bridge_trace_returns Returns:
+\code
+{
+    "returnValue": boolean,
+    "trace": {
+        "enabled": boolean,
+        "dropped": integer,
+        "calls": [{
+            "method": string,
+            "timestamp": integer,
+            "latency": number,
+            "requestSize": integer,
+            "responseSize": integer
+        }]
+    }
+}
+\endcode
+
+\param dropped Number of records overwritten before they were fetched.
+\param latency Milliseconds from the call to its first reply.
+*/
+bool WebAppManagerService::getBridgeTrace(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, GetBridgeTraceSchema);
+    if (!root)
+        return true;
+
+    QString appId = stringField(root, "appId");
+    bool clear = booleanField(root, "clear");
+
+    j_release(&root);
+
+    JsonWriter response(&mResponseBuffer);
+
+    response.beginObject();
+    response.member("returnValue", true);
+    response.key("trace");
+    mBridgeTrace.writeRecords(response, appId);
+    response.endObject();
+
+    request.respond(response.constData());
+
+    if (clear)
+        mBridgeTrace.clear(appId);
+
+    return true;
+}
+
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_start_trace startTrace
+
+\e Private
+
+org.webosports.webappmanager/startTrace
+
+Start recording trace events of the manager, its windows and the bridge.
+Events recorded by an earlier session that was not stopped are dropped.
+
+\subsection org_webosports_webappmanager_start_trace_syntax Syntax:
+\code
+{
+}
+\endcode
+*/
+bool WebAppManagerService::startTrace(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, StartTraceSchema);
+    if (!root)
+        return true;
+
+    j_release(&root);
+
+    Tracer::instance()->start();
+
+    request.respond("{\"returnValue\":true}");
+
+    return true;
+}
+
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_stop_trace stopTrace
+
+\e Private
+
+org.webosports.webappmanager/stopTrace
+
+Stop recording and write the events in the Chrome trace event format, ready
+to be loaded into chrome://tracing or Perfetto next to a trace of the
+renderer processes. Traces are only written to the webappmanager-traces
+directory below the temporary directory.
+
+\subsection org_webosports_webappmanager_stop_trace_syntax Syntax:
+\code
+{
+    "fileName": string
+}
+\endcode
+
+\param fileName Name of the file in the trace directory to write the trace
+to (optional), without any directory part. Defaults to a time stamped name.
+
+\subsection org_webosports_webappmanager_stop_trace_returns Returns:
+\code
+{
+    "returnValue": boolean,
+    "path": string,
+    "events": integer
+}
+\endcode
+*/
+bool WebAppManagerService::stopTrace(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, StopTraceSchema);
+    if (!root)
+        return true;
+
+    QString fileName = stringField(root, "fileName");
+
+    j_release(&root);
+
+    // the caller only picks a name, we don't write anywhere outside our directory
+    if (fileName.contains('/') || fileName == "." || fileName == "..") {
+        luna_service_message_reply_custom_error(LS::Handle::get(), request.get(), "Invalid trace file name");
+        return true;
+    }
+
+    if (!Tracer::isEnabled()) {
+        luna_service_message_reply_custom_error(LS::Handle::get(), request.get(), "Tracing is not running");
+        return true;
+    }
+
+    QDir traceDirectory(QDir::tempPath());
+    if (!traceDirectory.mkpath(TRACE_DIRECTORY_NAME) || !traceDirectory.cd(TRACE_DIRECTORY_NAME)) {
+        luna_service_message_reply_custom_error(LS::Handle::get(), request.get(), "Failed to create trace directory");
+        return true;
+    }
+
+    if (fileName.isEmpty())
+        fileName = QString("webappmanager-trace-%1.json").arg(QDateTime::currentMSecsSinceEpoch());
+
+    QString path = traceDirectory.filePath(fileName);
+
+    int eventCount = 0;
+    QByteArray trace = Tracer::instance()->stop(&eventCount);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(trace) != trace.size()) {
+        qCWarning(lcManager) << "Failed to write trace to" << path << ":" << file.errorString();
+        luna_service_message_reply_custom_error(LS::Handle::get(), request.get(), "Failed to write trace file");
+        return true;
+    }
+
+    JsonWriter response(&mResponseBuffer);
+
+    response.beginObject();
+    response.member("returnValue", true);
+    response.member("path", path);
+    response.member("events", eventCount);
+    response.endObject();
+
+    request.respond(response.constData());
+
+    return true;
+}
+
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_get_bridge_stats getBridgeStats
+
+\e Private
+
+org.webosports.webappmanager/getBridgeStats
+
+Return statistics of the service calls made by applications through the
+PalmServiceBridge, per application and service URI. They are collected all
+the time and kept after an application closed until they are cleared.
+
+\subsection org_webosports_webappmanager_get_bridge_stats_syntax Syntax:
+\code
+{
+    "appId": string,
+    "uri": string,
+    "clear": boolean
+}
+\endcode
+
+\param appId Only return the statistics of this application (optional).
+\param uri Only return the statistics of this service URI (optional).
+\param clear Reset the statistics of the selected applications after
+returning them (optional).
+
+\subsection org_webosports_webappmanager_get_bridge_stats_returns Returns:
+\code
+{
+    "returnValue": boolean,
+    "apps": [{
+        "appId": string,
+        "services": [{
+            "uri": string,
+            "calls": integer,
+            "failed": integer,
+            "cancelled": integer,
+            "firstReplyLatency": histogram,
+            "replies": histogram,
+            "requestSize": histogram,
+            "replySize": histogram
+        }]
+    }]
+}
+\endcode
+
+with every histogram being
+
+\code
+{
+    "count": integer,
+    "min": integer,
+    "max": integer,
+    "mean": number,
+    "p50": integer,
+    "p90": integer,
+    "p99": integer,
+    "buckets": [[integer, integer]]
+}
+\endcode
+
+\param failed Calls that could not be sent to the service.
+\param firstReplyLatency Microseconds from a call to its first reply.
+\param replies Replies per finished call, more than one for subscriptions.
+\param requestSize Payload sizes in bytes, replySize likewise.
+\param buckets The populated buckets as lower bound and count. Bucket bounds
+are exact to within 25% of the value.
+*/
+bool WebAppManagerService::getBridgeStats(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, GetBridgeStatsSchema);
+    if (!root)
+        return true;
+
+    QString appId = stringField(root, "appId");
+    QString uri = stringField(root, "uri");
+    bool clear = booleanField(root, "clear");
+
+    j_release(&root);
+
+    JsonWriter response(&mResponseBuffer);
+
+    response.beginObject();
+    response.member("returnValue", true);
+    response.key("apps");
+    mBridgeStats.writeStats(response, appId, uri);
+    response.endObject();
+
+    request.respond(response.constData());
+
+    if (clear)
+        mBridgeStats.clear(appId);
+
+    return true;
+}
+
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_get_process_policy getProcessPolicy
+
+\e Private
+
+org.webosports.webappmanager/getProcessPolicy
+
+Return the policy the renderer processes are shared by between applications
+and the number of renderer processes currently running. The policy is
+configured through the environment and applied at startup.
+
+\subsection org_webosports_webappmanager_get_process_policy_syntax Syntax:
+\code
+{
+}
+\endcode
+
+\subsection org_webosports_webappmanager_get_process_policy_returns Returns:
+\code
+{
+    "returnValue": boolean,
+    "policy": {
+        "systemRenderers": string,
+        "remoteRenderers": string,
+        "processPerSite": boolean,
+        "maxRenderers": integer,
+        "chromiumFlags": [string],
+        "skippedFlags": [string]
+    },
+    "renderers": integer
+}
+\endcode
+
+\param systemRenderers "shared" when all applications with a local entry
+point share their renderer, "dedicated" otherwise, the default.
+remoteRenderers likewise for remote applications of the same site.
+\param processPerSite Whether the web engine runs with --process-per-site.
+Either shared setting turns it on for the whole browser, so remote
+applications of the same site share their renderer even when
+remoteRenderers is "dedicated".
+\param maxRenderers Upper bound of renderer processes, 0 if left to the
+web engine.
+\param chromiumFlags Web engine flags the policy asks for.
+\param skippedFlags Flags of chromiumFlags left out because the web engine
+configuration sets the process model itself.
+*/
+bool WebAppManagerService::getProcessPolicy(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, GetProcessPolicySchema);
+    if (!root)
+        return true;
+
+    j_release(&root);
+
+    JsonWriter response(&mResponseBuffer);
+
+    response.beginObject();
+    response.member("returnValue", true);
+    response.key("policy");
+    mWebAppManager->processPolicy().write(response);
+    response.member("renderers", mResourceMonitor.rendererProcessCount());
+    response.endObject();
+
+    request.respond(response.constData());
+
+    return true;
+}
+
+/*!
+\page org_webosports_webappmanager
+\n
+\section org_webosports_webappmanager_get_device_profile getDeviceProfile
+
+\e Private
+
+org.webosports.webappmanager/getDeviceProfile
+
+Return the performance tier the device was put in at startup and the limits
+the manager runs with. Values set in the [DeviceProfile] group of
+/etc/luna-next/webappmanager.conf take precedence over the tier's.
+
+\subsection org_webosports_webappmanager_get_device_profile_syntax Syntax:
+\code
+{
+}
+\endcode
+
+\subsection org_webosports_webappmanager_get_device_profile_returns Returns:
+\code
+{
+    "returnValue": boolean,
+    "profile": {
+        "tier": string,
+        "device": {
+            "memoryTotal": integer,
+            "cores": integer,
+            "maxFrequency": integer,
+            "desktop": boolean
+        },
+        "stageReadyTimeout": integer,
+        "maxRendererRestarts": integer,
+        "maxLiveCards": integer,
+        "maxRenderers": integer,
+        "httpCacheSize": integer,
+        "lowEndDeviceMode": boolean,
+        "backgroundThrottling": boolean,
+        "overrides": [string]
+    }
+}
+\endcode
+
+\param tier One of "low", "mid" or "high".
+\param memoryTotal Memory in bytes, maxFrequency in MHz, 0 if unknown.
+\param stageReadyTimeout Milliseconds a card may take to become ready before
+it is shown anyway.
+\param maxLiveCards Cards kept running before the least recently launched one
+is closed, 0 for no limit.
+\param httpCacheSize Disk cache size in bytes.
+\param overrides The values taken from the configuration file.
+*/
+bool WebAppManagerService::getDeviceProfile(LSMessage &message)
+{
+    LS::Message request(&message);
+
+    jvalue_ref root = parseRequest(request, GetDeviceProfileSchema);
+    if (!root)
+        return true;
+
+    j_release(&root);
+
+    JsonWriter response(&mResponseBuffer);
+
+    response.beginObject();
+    response.member("returnValue", true);
+    response.key("profile");
+    mWebAppManager->deviceProfile().write(response);
+    response.endObject();
+
+    request.respond(response.constData());
+
+    return true;
+}
+
 } // namespace luna
@@ -19,7 +19,15 @@
 #define WEBAPPMANAGERSERVICE_H_
 
 #include <glib.h>
+#include <QByteArray>
+#include <QJsonObject>
 #include <luna-service2/lunaservice.hpp>
+#include <pbnjson.h>
+
+#include "appeventstream.h"
+#include "appresourcemonitor.h"
+#include "bridgestats.h"
+#include "bridgetrace.h"
 
 namespace luna
 {
@@ -32,12 +40,38 @@ public:
     WebAppManagerService(WebAppManager *webAppManager);
     ~WebAppManagerService();
 
-    void notifyAppHasStarted(const QString& appId, int64_t processId);
-    void notifyAppHasFinished(const QString& appId, int64_t processId);
+    void notifyAppEvent(const char *event, const QString &appId, int64_t processId,
+                        const QJsonObject &details = QJsonObject());
     
     LS::Handle &getServiceHandle() { return *this; }
+    AppResourceMonitor &resourceMonitor() { return mResourceMonitor; }
+    BridgeTrace &bridgeTrace() { return mBridgeTrace; }
+    BridgeStats &bridgeStats() { return mBridgeStats; }
 
 private:
+    enum RequestSchema {
+        LaunchAppSchema,
+        LaunchUrlSchema,
+        KillAppSchema,
+        IsAppRunningSchema,
+        ListRunningAppsSchema,
+        RegisterForAppEventsSchema,
+        RelaunchSchema,
+        ClearMemoryCachesSchema,
+        GetAppResourceUsageSchema,
+        SetLogLevelSchema,
+        SetBridgeTracingSchema,
+        GetBridgeTraceSchema,
+        StartTraceSchema,
+        StopTraceSchema,
+        GetBridgeStatsSchema,
+        GetProcessPolicySchema,
+        GetDeviceProfileSchema,
+        RequestSchemaCount
+    };
+
+    jvalue_ref parseRequest(LS::Message &request, RequestSchema schema);
+
     bool launchApp(LSMessage &message);
     bool launchUrl(LSMessage &message);
     bool killApp(LSMessage &message);
@@ -46,10 +80,24 @@ private:
     bool registerForAppEvents(LSMessage &message);
     bool relaunch(LSMessage &message);
     bool clearMemoryCaches(LSMessage &message);
+    bool getAppResourceUsage(LSMessage &message);
+    bool setLogLevel(LSMessage &message);
+    bool setBridgeTracing(LSMessage &message);
+    bool getBridgeTrace(LSMessage &message);
+    bool startTrace(LSMessage &message);
+    bool stopTrace(LSMessage &message);
+    bool getBridgeStats(LSMessage &message);
+    bool getProcessPolicy(LSMessage &message);
+    bool getDeviceProfile(LSMessage &message);
 
 private:
     WebAppManager *mWebAppManager;
-    LS::SubscriptionPoint mAppEventSubscriptions;
+    AppEventStream mAppEvents;
+    AppResourceMonitor mResourceMonitor;
+    BridgeTrace mBridgeTrace;
+    BridgeStats mBridgeStats;
+    QByteArray mResponseBuffer;
+    jschema_ref mSchemas[RequestSchemaCount];
 };
 
 } // namespace luna